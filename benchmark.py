@@ -2,6 +2,7 @@
 
 import subprocess
 import argparse
+import json
 from pathlib import Path
 import re
 from statistics import stdev, mean, median_high
@@ -14,6 +15,7 @@ num_runs = 10
 parser = argparse.ArgumentParser()
 parser.add_argument('-b', '--binary', type=str, help='Path to binary to benchmark', required=True)
 parser.add_argument('-i', '--input', type=str, help='Path to inputs for the benchmark. Should contain one sudoku per line.', required=True)
+parser.add_argument('--batch', action='store_true', help='Solve the whole input in one process per run (sudoku-cli --batch)')
 
 args = parser.parse_args()
 
@@ -41,13 +43,27 @@ def run_with_input(line):
         
     return mean(results), stdev(results)
 
+def run_batch():
+    times = {}
+    for i in range(num_runs):
+        foo = subprocess.run([args.binary, '--batch', args.input],
+                             universal_newlines=True,
+                             stdout=subprocess.PIPE,
+                             stderr=subprocess.PIPE)
+        for line in foo.stdout.splitlines():
+            result = json.loads(line)
+            times.setdefault(result['index'], []).append(result.get('time_ms', 0.0))
+    return [(mean(results), stdev(results)) for _, results in sorted(times.items())]
+
 
 with open(args.input, 'r') as input_file, open('table.md', 'w') as table_file, open('results.csv', 'w') as csv_file:
     table_file.write('| Problem | Time taken mean (ms) | Time taken stdev (ms) |\n')
     table_file.write('|---------|----------------------|-----------------------|\n')
-    for idx, line in enumerate(input_file):
-        line = line.rstrip()
-        result = run_with_input(line)
+    if args.batch:
+        results = run_batch()
+    else:
+        results = (run_with_input(line.rstrip()) for line in input_file)
+    for idx, result in enumerate(results):
         table_file.write('| {} | {} | {} |\n'.format(idx, *result))
         csv_file.write('{}, {}, {}\n'.format(idx, *result))
         print('Problem: {}, mean: {}, stdev: {}'.format(idx, *result))
@@ -0,0 +1,427 @@
+#include "board_archive.hpp"
+
+#include <cassert>
+#include <cstring>
+
+namespace {
+    const char MAGIC[4] = {'S', 'D', 'K', 'A'};
+    const std::uint8_t VERSION = 2;
+    // Version 1 stats lack the preprocessing fields, they read as zero
+    const std::uint8_t OLDEST_VERSION = 1;
+    const std::uint8_t CONTENTS_RESULTS = 1;
+    const std::uint8_t CONTENTS_STATS = 2;
+    // Offset of the record count in the header
+    const std::streamoff COUNT_OFFSET = 8;
+    // Solved and consistent bits, solutions and time_ms, without the solution
+    const size_t RESULT_SIZE = 1 + 4 + 8;
+    const size_t STATS_SIZE_V1 = 2 * 4 + 4 * 8 + 3 * 8;
+    const size_t STATS_SIZE = STATS_SIZE_V1 + 2 * 4 + 8;
+    const std::uint8_t SOLVED_BIT = 1;
+    const std::uint8_t CONSISTENT_BIT = 2;
+
+    // Smallest number of bits that holds the values 0 up to values
+    int bits_for(int values)
+    {
+        int bits = 1;
+        while ((1 << bits) <= values)
+        {
+            ++bits;
+        }
+        return bits;
+    }
+
+    size_t packed_size(int cells, int bits)
+    {
+        return (static_cast<size_t>(cells) * bits + 7) / 8;
+    }
+
+    size_t record_size(int cells, int bits, bool with_results, bool with_stats, int version = VERSION)
+    {
+        size_t size = packed_size(cells, bits);
+        if (with_results)
+        {
+            size += RESULT_SIZE + packed_size(cells, bits);
+        }
+        if (with_stats)
+        {
+            size += (version == 1) ? STATS_SIZE_V1 : STATS_SIZE;
+        }
+        return size;
+    }
+
+    std::uint8_t* put(std::uint8_t* out, std::uint64_t value, int bytes)
+    {
+        for (int i = 0; i < bytes; ++i)
+        {
+            *out++ = static_cast<std::uint8_t>(value >> (8 * i));
+        }
+        return out;
+    }
+
+    std::uint8_t* put_double(std::uint8_t* out, double value)
+    {
+        std::uint64_t bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return put(out, bits, 8);
+    }
+
+    std::uint64_t get(const std::uint8_t*& in, int bytes)
+    {
+        std::uint64_t value = 0;
+        for (int i = 0; i < bytes; ++i)
+        {
+            value |= static_cast<std::uint64_t>(*in++) << (8 * i);
+        }
+        return value;
+    }
+
+    double get_double(const std::uint8_t*& in)
+    {
+        const std::uint64_t bits = get(in, 8);
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    void write_number(std::ostream& out, std::uint64_t value, int bytes)
+    {
+        std::uint8_t buffer[8];
+        put(buffer, value, bytes);
+        out.write(reinterpret_cast<const char*>(buffer), bytes);
+    }
+
+    bool read_number(std::istream& in, int bytes, std::uint64_t& value)
+    {
+        std::uint8_t buffer[8];
+        if (!in.read(reinterpret_cast<char*>(buffer), bytes))
+        {
+            return false;
+        }
+        const std::uint8_t* data = buffer;
+        value = get(data, bytes);
+        return true;
+    }
+
+    std::uint8_t* pack_squares(const Square* squares, int count, int bits, std::uint8_t* out)
+    {
+        std::uint32_t pending = 0;
+        int pending_bits = 0;
+        for (int i = 0; i < count; ++i)
+        {
+            pending |= static_cast<std::uint32_t>(squares[i]) << pending_bits;
+            pending_bits += bits;
+            while (pending_bits >= 8)
+            {
+                *out++ = static_cast<std::uint8_t>(pending);
+                pending >>= 8;
+                pending_bits -= 8;
+            }
+        }
+        if (pending_bits > 0)
+        {
+            *out++ = static_cast<std::uint8_t>(pending);
+        }
+        return out;
+    }
+
+    // Returns false if a square is above values
+    bool unpack_squares(const std::uint8_t*& in, int count, int bits, int values, Square* squares)
+    {
+        const std::uint32_t mask = (1u << bits) - 1;
+        std::uint32_t pending = 0;
+        int pending_bits = 0;
+        bool valid = true;
+        for (int i = 0; i < count; ++i)
+        {
+            while (pending_bits < bits)
+            {
+                pending |= static_cast<std::uint32_t>(*in++) << pending_bits;
+                pending_bits += 8;
+            }
+            const std::uint32_t value = pending & mask;
+            valid = valid && (value <= static_cast<std::uint32_t>(values));
+            squares[i] = static_cast<Square>(value);
+            pending >>= bits;
+            pending_bits -= bits;
+        }
+        return valid;
+    }
+}
+
+BoardArchiveWriter::BoardArchiveWriter(std::ostream& out, const CompiledLayout& layout, bool with_results, bool with_stats)
+    : m_out(out)
+    , m_bits(bits_for(layout.get_values()))
+    , m_with_results(with_results)
+    , m_with_stats(with_stats)
+    , m_start(out.tellp())
+    , m_record(record_size(layout.get_cells(), m_bits, with_results, with_stats))
+{
+    assert((layout.get_cells() <= 0xffff) && (layout.get_values() <= 0xff) && "Layout does not fit the archive");
+    const Settings::Sudoku::BoardSettings& board_settings = layout.get_board_settings();
+    m_out.write(MAGIC, sizeof(MAGIC));
+    write_number(m_out, VERSION, 1);
+    write_number(m_out, (with_results ? CONTENTS_RESULTS : 0) | (with_stats ? CONTENTS_STATS : 0), 1);
+    write_number(m_out, m_bits, 1);
+    write_number(m_out, 0, 1);
+    write_number(m_out, 0, 8);
+    write_number(m_out, layout.get_rows(), 2);
+    write_number(m_out, layout.get_columns(), 2);
+    write_number(m_out, layout.get_values(), 2);
+    write_number(m_out, layout.get_region_count(), 2);
+    for (int region = 0; region < layout.get_region_count(); ++region)
+    {
+        write_number(m_out, static_cast<std::uint64_t>(board_settings.regions[region].second), 1);
+        write_number(m_out, layout.get_region(region).size(), 2);
+        for (int cell : layout.get_region(region))
+        {
+            write_number(m_out, cell, 2);
+        }
+    }
+    write_number(m_out, board_settings.empty_points.size(), 2);
+    for (const Point& point : board_settings.empty_points)
+    {
+        write_number(m_out, layout.to_cell(point.first, point.second), 2);
+    }
+}
+
+BoardArchiveWriter::~BoardArchiveWriter()
+{
+    finish();
+}
+
+bool BoardArchiveWriter::write(SudokuBoardView board, const SudokuBatchResult& result)
+{
+    assert(static_cast<size_t>(m_record.size()) == record_size(board.size(), m_bits, m_with_results, m_with_stats) &&
+           "Board does not match the layout of the archive");
+    std::uint8_t* out = pack_squares(board.data(), board.size(), m_bits, m_record.data());
+    if (m_with_results)
+    {
+        out = put(out, (result.solved ? SOLVED_BIT : 0) | (result.consistent ? CONSISTENT_BIT : 0), 1);
+        out = put(out, static_cast<std::uint32_t>(result.solutions), 4);
+        out = put_double(out, result.time_ms);
+        if (result.solved)
+        {
+            out = pack_squares(result.solution.data(), result.solution.size(), m_bits, out);
+        }
+        else
+        {
+            const size_t size = packed_size(board.size(), m_bits);
+            std::memset(out, 0, size);
+            out += size;
+        }
+    }
+    if (m_with_stats)
+    {
+        const SolverStats& stats = result.stats;
+        out = put(out, static_cast<std::uint32_t>(stats.variables), 4);
+        out = put(out, static_cast<std::uint32_t>(stats.clauses), 4);
+        out = put(out, stats.conflicts, 8);
+        out = put(out, stats.decisions, 8);
+        out = put(out, stats.propagations, 8);
+        out = put(out, stats.restarts, 8);
+        out = put_double(out, stats.encode_ms);
+        out = put_double(out, stats.apply_ms);
+        out = put_double(out, stats.solve_ms);
+        out = put(out, static_cast<std::uint32_t>(stats.eliminated_variables), 4);
+        out = put(out, static_cast<std::uint32_t>(stats.removed_clauses), 4);
+        out = put_double(out, stats.preprocess_ms);
+    }
+    m_out.write(reinterpret_cast<const char*>(m_record.data()), m_record.size());
+    ++m_count;
+    return m_out.good();
+}
+
+bool BoardArchiveWriter::finish()
+{
+    if (!m_finished)
+    {
+        m_finished = true;
+        const std::streampos end = m_out.tellp();
+        m_out.seekp(m_start + COUNT_OFFSET);
+        write_number(m_out, m_count, 8);
+        m_out.seekp(end);
+        m_out.flush();
+    }
+    return m_out.good();
+}
+
+std::unique_ptr<BoardArchiveReader> BoardArchiveReader::open(std::istream& in)
+{
+    std::unique_ptr<BoardArchiveReader> reader;
+    char magic[sizeof(MAGIC)];
+    std::uint64_t version, contents, bits, reserved, count, rows, columns, values, regions;
+    if (!in.read(magic, sizeof(magic)) || (std::memcmp(magic, MAGIC, sizeof(MAGIC)) != 0) ||
+        !read_number(in, 1, version) || (version < OLDEST_VERSION) || (version > VERSION) ||
+        !read_number(in, 1, contents) || !read_number(in, 1, bits) || !read_number(in, 1, reserved) ||
+        !read_number(in, 8, count) || !read_number(in, 2, rows) || !read_number(in, 2, columns) ||
+        !read_number(in, 2, values) || !read_number(in, 2, regions))
+    {
+        return reader;
+    }
+    const std::uint64_t cells = rows * columns;
+    if ((cells == 0) || (cells > 0xffff) || (values == 0) || (values > 0xff) || (bits != static_cast<std::uint64_t>(bits_for(values))))
+    {
+        return reader;
+    }
+
+    Settings::Sudoku::BoardSettings board_settings;
+    board_settings.rows = static_cast<int>(rows);
+    board_settings.columns = static_cast<int>(columns);
+    board_settings.values = static_cast<int>(values);
+    board_settings.min_value = 0;
+    board_settings.max_value = static_cast<int>(values);
+    board_settings.has_example = false;
+    std::uint64_t color, size, cell;
+    for (std::uint64_t region = 0; region < regions; ++region)
+    {
+        if (!read_number(in, 1, color) || (color > static_cast<std::uint64_t>(Settings::PuzzleColor::B_DARK)) ||
+            !read_number(in, 2, size))
+        {
+            return reader;
+        }
+        Region points;
+        points.second = static_cast<Settings::PuzzleColor>(color);
+        for (std::uint64_t i = 0; i < size; ++i)
+        {
+            if (!read_number(in, 2, cell) || (cell >= cells))
+            {
+                return reader;
+            }
+            points.first.emplace_back(static_cast<Position>(cell / columns), static_cast<Position>(cell % columns));
+        }
+        board_settings.regions.push_back(points);
+    }
+    if (!read_number(in, 2, size))
+    {
+        return reader;
+    }
+    for (std::uint64_t i = 0; i < size; ++i)
+    {
+        if (!read_number(in, 2, cell) || (cell >= cells))
+        {
+            return reader;
+        }
+        board_settings.empty_points.emplace(static_cast<Position>(cell / columns), static_cast<Position>(cell % columns));
+    }
+    reader = std::unique_ptr<BoardArchiveReader>(new BoardArchiveReader(in, CompiledLayout::compile(std::move(board_settings)),
+                                                                        static_cast<int>(version), static_cast<int>(bits),
+                                                                        (contents & CONTENTS_RESULTS) != 0, (contents & CONTENTS_STATS) != 0,
+                                                                        count));
+    return reader;
+}
+
+BoardArchiveReader::BoardArchiveReader(std::istream& in, std::shared_ptr<const CompiledLayout> layout, int version, int bits,
+                                       bool with_results, bool with_stats, std::uint64_t count)
+    : m_in(in)
+    , m_layout(std::move(layout))
+    , m_version(version)
+    , m_bits(bits)
+    , m_with_results(with_results)
+    , m_with_stats(with_stats)
+    , m_count(count)
+    , m_data_start(in.tellg())
+    , m_record(record_size(m_layout->get_cells(), bits, with_results, with_stats, version))
+{
+}
+
+const std::shared_ptr<const CompiledLayout>& BoardArchiveReader::get_layout() const
+{
+    return m_layout;
+}
+
+std::uint64_t BoardArchiveReader::size() const
+{
+    return m_count;
+}
+
+bool BoardArchiveReader::has_results() const
+{
+    return m_with_results;
+}
+
+bool BoardArchiveReader::has_stats() const
+{
+    return m_with_stats;
+}
+
+bool BoardArchiveReader::read(std::uint64_t index, SudokuBoard& board)
+{
+    if (!read_record(index))
+    {
+        return false;
+    }
+    if ((board.get_rows() != m_layout->get_rows()) || (board.get_columns() != m_layout->get_columns()))
+    {
+        board = SudokuBoard(m_layout->get_rows(), m_layout->get_columns());
+    }
+    const std::uint8_t* in = m_record.data();
+    return unpack_squares(in, board.size(), m_bits, m_layout->get_values(), board.data());
+}
+
+bool BoardArchiveReader::read(std::uint64_t index, SudokuBoard& board, SudokuBatchResult& result)
+{
+    if (!read(index, board))
+    {
+        return false;
+    }
+    result = SudokuBatchResult();
+    const std::uint8_t* in = m_record.data() + packed_size(board.size(), m_bits);
+    bool valid = true;
+    if (m_with_results)
+    {
+        const std::uint64_t flags = get(in, 1);
+        result.solved = (flags & SOLVED_BIT) != 0;
+        result.consistent = (flags & CONSISTENT_BIT) != 0;
+        result.solutions = static_cast<int>(get(in, 4));
+        result.time_ms = get_double(in);
+        if (result.solved)
+        {
+            result.solution = SudokuBoard(m_layout->get_rows(), m_layout->get_columns());
+            valid = unpack_squares(in, board.size(), m_bits, m_layout->get_values(), result.solution.data());
+        }
+        else
+        {
+            in += packed_size(board.size(), m_bits);
+        }
+    }
+    if (m_with_stats)
+    {
+        SolverStats& stats = result.stats;
+        stats.variables = static_cast<int>(get(in, 4));
+        stats.clauses = static_cast<int>(get(in, 4));
+        stats.conflicts = get(in, 8);
+        stats.decisions = get(in, 8);
+        stats.propagations = get(in, 8);
+        stats.restarts = get(in, 8);
+        stats.encode_ms = get_double(in);
+        stats.apply_ms = get_double(in);
+        stats.solve_ms = get_double(in);
+        if (m_version >= 2)
+        {
+            stats.eliminated_variables = static_cast<std::int32_t>(get(in, 4));
+            stats.removed_clauses = static_cast<std::int32_t>(get(in, 4));
+            stats.preprocess_ms = get_double(in);
+        }
+    }
+    return valid;
+}
+
+bool BoardArchiveReader::read_record(std::uint64_t index)
+{
+    if (index >= m_count)
+    {
+        return false;
+    }
+    if (index != m_next_index)
+    {
+        m_in.clear();
+        m_in.seekg(m_data_start + static_cast<std::streamoff>(index * m_record.size()));
+    }
+    m_next_index = m_count;
+    if (!m_in.read(reinterpret_cast<char*>(m_record.data()), m_record.size()))
+    {
+        return false;
+    }
+    m_next_index = index + 1;
+    return true;
+}
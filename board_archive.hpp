@@ -0,0 +1,91 @@
+#pragma once
+
+#include "compiledlayout.hpp"
+#include "sudokubatchsolver.hpp"
+#include "sudokuboard.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <vector>
+
+// Binary container for many boards of one layout, optionally with the
+// result and statistics of solving them. The header holds the layout once:
+// the size, the regions and the empty points. It is followed by records of
+// a fixed size, so record i is found without reading the ones before it.
+// Squares are packed in as few bits as the values need, 4 bits for 9x9 and
+// 5 bits for 16x16 and 25x25 boards. All numbers are little endian.
+//
+//  header  "SDKA", version, contents, bits per square, 0, record count (64 bits),
+//          rows, columns, values, regions (16 bits each), per region its
+//          color (8 bits), cell count and cells (16 bits each), then the
+//          empty point count and cells (16 bits each)
+//  record  board, then with results: solved and consistent bits (8 bits),
+//          solutions (32 bits), time_ms (double) and solution, then with
+//          stats: variables and clauses (32 bits each), conflicts,
+//          decisions, propagations and restarts (64 bits each),
+//          encode_ms, apply_ms and solve_ms (doubles), eliminated_variables
+//          and removed_clauses (32 bits each) and preprocess_ms (double)
+//
+// Version 1 archives, whose stats end with solve_ms, are still read, with
+// the preprocessing stats left at zero.
+class BoardArchiveWriter
+{
+public:
+    // Writes the header to out, which has to be seekable to fill in the
+    // record count when finishing
+    BoardArchiveWriter(std::ostream& out, const CompiledLayout& layout, bool with_results = false, bool with_stats = false);
+    // Finishes the archive if that was not done yet
+    ~BoardArchiveWriter();
+
+    // The result is ignored for archives without results and stats
+    bool write(SudokuBoardView board, const SudokuBatchResult& result = SudokuBatchResult());
+    // Writes the record count, returns false if any write failed
+    bool finish();
+
+private:
+    std::ostream& m_out;
+    const int m_bits;
+    const bool m_with_results;
+    const bool m_with_stats;
+    std::streampos m_start;
+    std::uint64_t m_count = 0;
+    bool m_finished = false;
+    std::vector<std::uint8_t> m_record;
+};
+
+class BoardArchiveReader
+{
+public:
+    // Returns nullptr if in does not start with a valid archive header. The
+    // stream has to stay alive and seekable while the reader is used.
+    static std::unique_ptr<BoardArchiveReader> open(std::istream& in);
+
+    const std::shared_ptr<const CompiledLayout>& get_layout() const;
+    std::uint64_t size() const;
+    bool has_results() const;
+    bool has_stats() const;
+
+    // Reading the records in order never seeks. Both return false if the
+    // record cannot be read or holds squares above the number of values.
+    bool read(std::uint64_t index, SudokuBoard& board);
+    bool read(std::uint64_t index, SudokuBoard& board, SudokuBatchResult& result);
+
+private:
+    BoardArchiveReader(std::istream& in, std::shared_ptr<const CompiledLayout> layout, int version, int bits,
+                       bool with_results, bool with_stats, std::uint64_t count);
+
+    bool read_record(std::uint64_t index);
+
+    std::istream& m_in;
+    const std::shared_ptr<const CompiledLayout> m_layout;
+    const int m_version;
+    const int m_bits;
+    const bool m_with_results;
+    const bool m_with_stats;
+    const std::uint64_t m_count;
+    std::streampos m_data_start;
+    std::uint64_t m_next_index = 0;
+    std::vector<std::uint8_t> m_record;
+};
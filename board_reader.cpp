@@ -0,0 +1,161 @@
+#include "board_reader.hpp"
+
+#include <array>
+#include <cstring>
+
+namespace {
+    // Bytes read from the stream at once, lines longer than this grow the buffer
+    const size_t CHUNK_SIZE = 1 << 20;
+    // Value of a glyph, more than any side for invalid glyphs
+    const Square INVALID_GLYPH = 0xff;
+
+    std::array<Square, 256> make_glyph_values()
+    {
+        std::array<Square, 256> values;
+        values.fill(INVALID_GLYPH);
+        values['.'] = 0;
+        for (char c = '0'; c <= '9'; ++c)
+        {
+            values[static_cast<unsigned char>(c)] = c - '0';
+        }
+        for (char c = 'A'; c <= 'P'; ++c)
+        {
+            values[static_cast<unsigned char>(c)] = c - 'A' + 10;
+            values[static_cast<unsigned char>(c - 'A' + 'a')] = c - 'A' + 10;
+        }
+        return values;
+    }
+
+    const std::array<Square, 256> GLYPH_VALUES = make_glyph_values();
+
+    // Returns the side of a square board with size squares, or 0
+    int side_of(size_t size)
+    {
+        for (int side : {9, 16, 25})
+        {
+            if (size == static_cast<size_t>(side * side))
+            {
+                return side;
+            }
+        }
+        return 0;
+    }
+}
+
+BoardReader::BoardReader(std::istream& in, int side)
+    : m_in(in)
+    , m_side(side)
+    , m_buffer(CHUNK_SIZE)
+{
+}
+
+BoardReader::Status BoardReader::read(SudokuBoard& board)
+{
+    const char* first;
+    const char* last;
+    while (next_line(first, last))
+    {
+        ++m_line_index;
+        if ((last != first) && (*(last - 1) == '\r'))
+        {
+            --last;
+        }
+        if (last != first)
+        {
+            return parse(first, last, board);
+        }
+    }
+    return Status::END;
+}
+
+int BoardReader::get_side() const
+{
+    return m_side;
+}
+
+int BoardReader::get_line_index() const
+{
+    return m_line_index;
+}
+
+std::string BoardReader::get_error_message() const
+{
+    switch (m_error)
+    {
+    case Error::INVALID_SIZE:
+        return "invalid size " + std::to_string(m_error_size);
+    case Error::INVALID_CHARACTER:
+        return std::string("invalid character '") + m_error_character + "'";
+    case Error::NONE:
+        break;
+    }
+    return std::string();
+}
+
+bool BoardReader::next_line(const char*& first, const char*& last)
+{
+    while (true)
+    {
+        const char* begin = m_buffer.data() + m_position;
+        const char* end = m_buffer.data() + m_filled;
+        const char* newline = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+        if (newline)
+        {
+            first = begin;
+            last = newline;
+            m_position = newline + 1 - m_buffer.data();
+            return true;
+        }
+        if (m_end_of_stream)
+        {
+            // The last line may lack its newline
+            first = begin;
+            last = end;
+            m_position = m_filled;
+            return begin != end;
+        }
+        // Move the start of the line to the front and read the next chunk behind it
+        const size_t partial = m_filled - m_position;
+        std::memmove(m_buffer.data(), begin, partial);
+        m_position = 0;
+        m_filled = partial;
+        if (m_filled == m_buffer.size())
+        {
+            m_buffer.resize(2 * m_buffer.size());
+        }
+        m_in.read(m_buffer.data() + m_filled, m_buffer.size() - m_filled);
+        m_filled += static_cast<size_t>(m_in.gcount());
+        m_end_of_stream = !m_in;
+    }
+}
+
+BoardReader::Status BoardReader::parse(const char* first, const char* last, SudokuBoard& board)
+{
+    const size_t size = last - first;
+    const int side = (m_side != 0) ? m_side : side_of(size);
+    if ((side == 0) || (size != static_cast<size_t>(side * side)))
+    {
+        m_error = Error::INVALID_SIZE;
+        m_error_size = size;
+        return Status::INVALID;
+    }
+    if ((board.get_rows() != side) || (board.get_columns() != side))
+    {
+        board = SudokuBoard(side, side);
+    }
+    Square* square = board.data();
+    for (const char* c = first; c != last; ++c, ++square)
+    {
+        const Square value = GLYPH_VALUES[static_cast<unsigned char>(*c)];
+        if (value > side)
+        {
+            m_error = Error::INVALID_CHARACTER;
+            m_error_character = *c;
+            return Status::INVALID;
+        }
+        *square = value;
+    }
+    m_side = side;
+    m_error = Error::NONE;
+    return Status::BOARD;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "sudokuboard.hpp"
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <vector>
+
+// Reads boards of 9x9, 16x16 or 25x25 squares, one per line and in row-major
+// order, from a stream of any size. The stream is read in large chunks and
+// every line is parsed straight from the buffer into the board, so a corpus
+// is read at about the speed of the disk. Squares are . or 0 when empty,
+// 1-9 and A, B, ... (or a, b, ...) for values above 9, which is also the
+// format sudoku-cli writes. Lines ending in \r\n are accepted.
+//
+// Malformed lines are reported through the status and get_error_message
+// instead of exceptions, so a corpus with a few broken lines can still be
+// read to the end.
+class BoardReader
+{
+public:
+    enum class Status
+    {
+        BOARD,
+        // The line is not a board, see get_error_message
+        INVALID,
+        END,
+    };
+
+    // A side of 0 takes the side of the first board, after which all boards
+    // must have that side
+    explicit BoardReader(std::istream& in, int side = 0);
+
+    // Reads the next non-empty line into board, reusing its squares when it
+    // already has the right size
+    Status read(SudokuBoard& board);
+
+    // The side of the boards, 0 until the first board was read
+    int get_side() const;
+    // Zero based line number of the last line read, counting empty lines
+    int get_line_index() const;
+    // Describes why the last line was invalid
+    std::string get_error_message() const;
+
+private:
+    enum class Error
+    {
+        NONE,
+        INVALID_SIZE,
+        INVALID_CHARACTER,
+    };
+
+    bool next_line(const char*& first, const char*& last);
+    Status parse(const char* first, const char* last, SudokuBoard& board);
+
+    std::istream& m_in;
+    int m_side;
+    int m_line_index = -1;
+    std::vector<char> m_buffer;
+    size_t m_position = 0;
+    size_t m_filled = 0;
+    bool m_end_of_stream = false;
+    Error m_error = Error::NONE;
+    size_t m_error_size = 0;
+    char m_error_character = 0;
+};
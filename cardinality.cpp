@@ -0,0 +1,192 @@
+#include "cardinality.hpp"
+
+#include <cmath>
+#include <iostream>
+
+namespace Cardinality {
+
+namespace {
+    // Largest constraint for which AUTO keeps the pairwise encoding
+    const int AUTO_PAIRWISE_LIMIT = 10;
+    const int COMMANDER_GROUP_SIZE = 3;
+    // Below this size the product encoding recurses into pairwise
+    const int PRODUCT_PAIRWISE_LIMIT = 4;
+
+    void log_var(Minisat::Lit lit) {
+        if (sign(lit)) {
+            std::clog << '-';
+        }
+        std::clog << var(lit) + 1 << ' ';
+    }
+
+    void log_clause(Minisat::vec<Minisat::Lit> const& clause) {
+        for (int i = 0; i < clause.size(); ++i) {
+            log_var(clause[i]);
+        }
+        std::clog << "0\n";
+    }
+
+    void log_clause(Minisat::Lit lhs, Minisat::Lit rhs) {
+        log_var(lhs); log_var(rhs);
+        std::clog << "0\n";
+    }
+
+    void add_clause(SatBackend& solver, Minisat::Lit lhs, Minisat::Lit rhs, bool write_dimacs) {
+        if (write_dimacs) {
+            log_clause(lhs, rhs);
+        }
+        solver.add_clause(lhs, rhs);
+    }
+
+    void add_clause(SatBackend& solver, Minisat::vec<Minisat::Lit> const& literals, bool write_dimacs) {
+        if (write_dimacs) {
+            log_clause(literals);
+        }
+        solver.add_clause(literals);
+    }
+
+    Minisat::Lit new_literal(SatBackend& solver) {
+        return Minisat::mkLit(solver.new_var());
+    }
+
+    void pairwise(SatBackend& solver, Minisat::vec<Minisat::Lit> const& literals, bool write_dimacs) {
+        for (int i = 0; i < literals.size(); ++i) {
+            for (int j = i + 1; j < literals.size(); ++j) {
+                add_clause(solver, ~literals[i], ~literals[j], write_dimacs);
+            }
+        }
+    }
+
+    // s_i is true if any of the first i + 1 literals is true
+    void sequential(SatBackend& solver, Minisat::vec<Minisat::Lit> const& literals, bool write_dimacs) {
+        const int n = literals.size();
+        Minisat::Lit previous = new_literal(solver);
+        add_clause(solver, ~literals[0], previous, write_dimacs);
+        for (int i = 1; i < n - 1; ++i) {
+            Minisat::Lit current = new_literal(solver);
+            add_clause(solver, ~literals[i], current, write_dimacs);
+            add_clause(solver, ~previous, current, write_dimacs);
+            add_clause(solver, ~literals[i], ~previous, write_dimacs);
+            previous = current;
+        }
+        add_clause(solver, ~literals[n - 1], ~previous, write_dimacs);
+    }
+
+    // Every group gets a commander that is true iff one of its literals is;
+    // at most one commander may be true.
+    void commander(SatBackend& solver, Minisat::vec<Minisat::Lit> const& literals, bool write_dimacs) {
+        if (literals.size() <= COMMANDER_GROUP_SIZE) {
+            pairwise(solver, literals, write_dimacs);
+            return;
+        }
+        Minisat::vec<Minisat::Lit> commanders;
+        for (int begin = 0; begin < literals.size(); begin += COMMANDER_GROUP_SIZE) {
+            Minisat::vec<Minisat::Lit> group;
+            for (int i = begin; (i < begin + COMMANDER_GROUP_SIZE) && (i < literals.size()); ++i) {
+                group.push(literals[i]);
+            }
+            Minisat::Lit group_commander = new_literal(solver);
+            pairwise(solver, group, write_dimacs);
+            Minisat::vec<Minisat::Lit> commander_implies_group;
+            commander_implies_group.push(~group_commander);
+            for (int i = 0; i < group.size(); ++i) {
+                add_clause(solver, ~group[i], group_commander, write_dimacs);
+                commander_implies_group.push(group[i]);
+            }
+            add_clause(solver, commander_implies_group, write_dimacs);
+            commanders.push(group_commander);
+        }
+        commander(solver, commanders, write_dimacs);
+    }
+
+    // Literals are laid out on a grid; a true literal selects its row and
+    // column, and at most one row and one column may be selected.
+    void product(SatBackend& solver, Minisat::vec<Minisat::Lit> const& literals, bool write_dimacs) {
+        if (literals.size() <= PRODUCT_PAIRWISE_LIMIT) {
+            pairwise(solver, literals, write_dimacs);
+            return;
+        }
+        const int n = literals.size();
+        const int rows = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(n))));
+        const int columns = (n + rows - 1) / rows;
+        Minisat::vec<Minisat::Lit> row_literals;
+        Minisat::vec<Minisat::Lit> column_literals;
+        for (int row = 0; row < rows; ++row) {
+            row_literals.push(new_literal(solver));
+        }
+        for (int column = 0; column < columns; ++column) {
+            column_literals.push(new_literal(solver));
+        }
+        for (int i = 0; i < n; ++i) {
+            add_clause(solver, ~literals[i], row_literals[i / columns], write_dimacs);
+            add_clause(solver, ~literals[i], column_literals[i % columns], write_dimacs);
+        }
+        product(solver, row_literals, write_dimacs);
+        product(solver, column_literals, write_dimacs);
+    }
+
+    // Literals are split in groups of two; a true literal forces the bits
+    // to the binary index of its group.
+    void bimander(SatBackend& solver, Minisat::vec<Minisat::Lit> const& literals, bool write_dimacs) {
+        const int group_size = 2;
+        const int groups = (literals.size() + group_size - 1) / group_size;
+        int bit_count = 0;
+        while ((1 << bit_count) < groups) {
+            ++bit_count;
+        }
+        Minisat::vec<Minisat::Lit> bits;
+        for (int bit = 0; bit < bit_count; ++bit) {
+            bits.push(new_literal(solver));
+        }
+        for (int group = 0; group < groups; ++group) {
+            Minisat::vec<Minisat::Lit> group_literals;
+            for (int i = group * group_size; (i < (group + 1) * group_size) && (i < literals.size()); ++i) {
+                group_literals.push(literals[i]);
+            }
+            pairwise(solver, group_literals, write_dimacs);
+            for (int i = 0; i < group_literals.size(); ++i) {
+                for (int bit = 0; bit < bit_count; ++bit) {
+                    const bool bit_set = ((group >> bit) & 1) != 0;
+                    add_clause(solver, ~group_literals[i], bit_set ? bits[bit] : ~bits[bit], write_dimacs);
+                }
+            }
+        }
+    }
+}
+
+void at_most_one(SatBackend& solver, Minisat::vec<Minisat::Lit> const& literals, Settings::AmoEncoding encoding, bool write_dimacs) {
+    if (literals.size() < 2) {
+        return;
+    }
+    switch (encoding) {
+    case Settings::AmoEncoding::PAIRWISE:
+        pairwise(solver, literals, write_dimacs);
+        break;
+    case Settings::AmoEncoding::SEQUENTIAL:
+        sequential(solver, literals, write_dimacs);
+        break;
+    case Settings::AmoEncoding::COMMANDER:
+        commander(solver, literals, write_dimacs);
+        break;
+    case Settings::AmoEncoding::PRODUCT:
+        product(solver, literals, write_dimacs);
+        break;
+    case Settings::AmoEncoding::BIMANDER:
+        bimander(solver, literals, write_dimacs);
+        break;
+    case Settings::AmoEncoding::AUTO:
+        if (literals.size() <= AUTO_PAIRWISE_LIMIT) {
+            pairwise(solver, literals, write_dimacs);
+        } else {
+            product(solver, literals, write_dimacs);
+        }
+        break;
+    }
+}
+
+void exactly_one(SatBackend& solver, Minisat::vec<Minisat::Lit> const& literals, Settings::AmoEncoding encoding, bool write_dimacs) {
+    add_clause(solver, literals, write_dimacs);
+    at_most_one(solver, literals, encoding, write_dimacs);
+}
+
+}
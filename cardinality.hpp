@@ -0,0 +1,12 @@
+#pragma once
+
+#include "sat_backend.hpp"
+#include "solver_options.hpp"
+
+namespace Cardinality {
+    // Adds clauses allowing at most one of the literals to be true. Depending
+    // on the encoding, auxiliary variables are added to the solver.
+    void at_most_one(SatBackend& solver, Minisat::vec<Minisat::Lit> const& literals, Settings::AmoEncoding encoding, bool write_dimacs = false);
+    // Adds clauses forcing exactly one of the literals to be true
+    void exactly_one(SatBackend& solver, Minisat::vec<Minisat::Lit> const& literals, Settings::AmoEncoding encoding, bool write_dimacs = false);
+}
@@ -0,0 +1,115 @@
+#include "compiledlayout.hpp"
+#include "square_layout.hpp"
+
+#include <algorithm>
+#include <map>
+#include <mutex>
+
+namespace
+{
+    template <int Box>
+    bool is_square_layout(const CompiledLayout& layout)
+    {
+        using Layout = SquareLayout<Box>;
+        if ((layout.get_rows() != Layout::SIZE) || (layout.get_columns() != Layout::SIZE) || (layout.get_values() != Layout::SIZE)
+            || !layout.get_board_settings().empty_points.empty() || (layout.get_region_count() != Layout::REGIONS))
+        {
+            return false;
+        }
+        for (int region = 0; region < Layout::REGIONS; ++region)
+        {
+            const CellRange cells = layout.get_region(region);
+            if (!std::equal(cells.begin(), cells.end(), Layout::tables.regions[region], Layout::tables.regions[region] + Layout::SIZE))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Only 9x9 and 16x16 get specialized engines. The fixed size states of
+    // a 25x25 board would take too much stack in a deep search.
+    int find_square_box(const CompiledLayout& layout)
+    {
+        if (is_square_layout<3>(layout))
+        {
+            return 3;
+        }
+        if (is_square_layout<4>(layout))
+        {
+            return 4;
+        }
+        return 0;
+    }
+}
+
+std::shared_ptr<const CompiledLayout> CompiledLayout::compile(Settings::Sudoku::BoardSettings board_settings)
+{
+    return std::shared_ptr<const CompiledLayout>(new CompiledLayout(std::move(board_settings)));
+}
+
+std::shared_ptr<const CompiledLayout> CompiledLayout::get(Settings::Sudoku::Type type)
+{
+    static std::mutex mutex;
+    static std::map<Settings::Sudoku::Type, std::shared_ptr<const CompiledLayout>> layouts;
+    std::lock_guard<std::mutex> lock(mutex);
+    auto& layout = layouts[type];
+    if (!layout)
+    {
+        layout = compile(Settings::Sudoku::get_board_settings(type));
+    }
+    return layout;
+}
+
+CompiledLayout::CompiledLayout(Settings::Sudoku::BoardSettings board_settings)
+    : m_board_settings(std::move(board_settings))
+{
+    const int cells = m_board_settings.rows * m_board_settings.columns;
+    m_cell_mask.assign(cells, 1);
+    for (const Point& point : m_board_settings.empty_points)
+    {
+        m_cell_mask[to_cell(point.first, point.second)] = 0;
+    }
+
+    m_region_offsets.push_back(0);
+    for (const Region& region : m_board_settings.regions)
+    {
+        for (const Point& point : region.first)
+        {
+            m_region_cells.push_back(to_cell(point.first, point.second));
+        }
+        m_region_offsets.push_back(static_cast<int>(m_region_cells.size()));
+    }
+
+    std::vector<std::vector<int>> peers(cells);
+    std::vector<bool> active(cells, false);
+    for (int region = 0; region < get_region_count(); ++region)
+    {
+        for (int cell : get_region(region))
+        {
+            active[cell] = true;
+            for (int peer : get_region(region))
+            {
+                if (peer != cell)
+                {
+                    peers[cell].push_back(peer);
+                }
+            }
+        }
+    }
+    m_peer_offsets.push_back(0);
+    m_cell_variables.push_back(0);
+    for (int cell = 0; cell < cells; ++cell)
+    {
+        std::sort(peers[cell].begin(), peers[cell].end());
+        peers[cell].erase(std::unique(peers[cell].begin(), peers[cell].end()), peers[cell].end());
+        m_peers.insert(m_peers.end(), peers[cell].begin(), peers[cell].end());
+        m_peer_offsets.push_back(static_cast<int>(m_peers.size()));
+        if (active[cell])
+        {
+            m_active_cells.push_back(cell);
+        }
+        m_cell_variables.push_back(m_cell_variables.back() + (active[cell] ? m_board_settings.values : 0));
+    }
+    m_square_box = find_square_box(*this);
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "puzzle_types.hpp"
+#include "sudokusolver.hpp"
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Cells of the board that are stored one after the other
+class CellRange
+{
+public:
+    CellRange(const int* first, const int* last)
+        : m_first(first)
+        , m_last(last)
+    {
+    }
+
+    const int* begin() const { return m_first; }
+    const int* end() const { return m_last; }
+    int size() const { return static_cast<int>(m_last - m_first); }
+
+private:
+    const int* m_first;
+    const int* m_last;
+};
+
+// The board settings together with the flat index arrays the engines work
+// on. A layout never changes after it was built, so one instance is shared
+// by every puzzle, session and engine that uses it. Cells are numbered
+// row * columns + column.
+class CompiledLayout
+{
+public:
+    // Builds the layout of loaded or edited board settings
+    static std::shared_ptr<const CompiledLayout> compile(Settings::Sudoku::BoardSettings board_settings);
+    // Returns the layout of a predefined type, which is built on first use only
+    static std::shared_ptr<const CompiledLayout> get(Settings::Sudoku::Type type);
+
+    const Settings::Sudoku::BoardSettings& get_board_settings() const { return m_board_settings; }
+    int get_rows() const { return m_board_settings.rows; }
+    int get_columns() const { return m_board_settings.columns; }
+    int get_values() const { return m_board_settings.values; }
+    int get_cells() const { return static_cast<int>(m_cell_mask.size()); }
+
+    int to_cell(Position row, Position column) const
+    {
+        return row * m_board_settings.columns + column;
+    }
+    // False for the empty points, which never hold a value
+    bool is_used(int cell) const { return m_cell_mask[cell] != 0; }
+    // True for the cells of get_active_cells, the only ones with variables
+    bool is_active(int cell) const { return m_cell_variables[cell] != m_cell_variables[cell + 1]; }
+    // The variables of a cell are [first_variable(cell), first_variable(cell + 1)),
+    // one per value for active cells and none for the others, so the
+    // variables of the active cells are numbered without gaps
+    int first_variable(int cell) const { return m_cell_variables[cell]; }
+    int get_variables() const { return m_cell_variables.back(); }
+
+    int get_region_count() const { return static_cast<int>(m_region_offsets.size()) - 1; }
+    // The cells of a region, in the order of its points
+    CellRange get_region(int region) const
+    {
+        return CellRange(m_region_cells.data() + m_region_offsets[region], m_region_cells.data() + m_region_offsets[region + 1]);
+    }
+    // Cells that are part of at least one region
+    const std::vector<int>& get_active_cells() const { return m_active_cells; }
+    // The other cells that share a region with the cell, in increasing order
+    CellRange get_peers(int cell) const
+    {
+        return CellRange(m_peers.data() + m_peer_offsets[cell], m_peers.data() + m_peer_offsets[cell + 1]);
+    }
+    // Side of the boxes if the layout is the 9x9 or 16x16 SquareLayout, with
+    // the same regions in the same order, otherwise 0
+    int get_square_box() const { return m_square_box; }
+
+private:
+    explicit CompiledLayout(Settings::Sudoku::BoardSettings board_settings);
+
+    const Settings::Sudoku::BoardSettings m_board_settings;
+    std::vector<std::uint8_t> m_cell_mask;
+    std::vector<int> m_cell_variables;
+    std::vector<int> m_region_cells;
+    std::vector<int> m_region_offsets;
+    std::vector<int> m_active_cells;
+    std::vector<int> m_peers;
+    std::vector<int> m_peer_offsets;
+    int m_square_box = 0;
+};
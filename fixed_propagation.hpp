@@ -0,0 +1,44 @@
+#pragma once
+
+#include "compiledlayout.hpp"
+#include "single_propagation.hpp"
+#include "square_layout.hpp"
+#include "sudokuboard.hpp"
+#include <array>
+#include <cstdint>
+#include <type_traits>
+
+// The tables of BasicSinglePropagation for the square sudoku of
+// SquareLayout<Box>. They are known at compile time, so the loops of the
+// propagation have fixed trip counts, the candidates fit the values exactly
+// and a state is a pair of arrays instead of vectors on the heap.
+template <int Box>
+class FixedTables {
+public:
+    using Layout = SquareLayout<Box>;
+    using Candidates = std::conditional_t<(Layout::SIZE <= 16), std::uint16_t, std::uint32_t>;
+    using CandidateCells = std::array<Candidates, Layout::CELLS>;
+    using ValueCells = std::array<Square, Layout::CELLS>;
+
+    // The layout has to be the square layout, see supports
+    explicit FixedTables(const CompiledLayout& layout)
+    {
+        assert(supports(layout) && "Not the square layout of the tables");
+        (void)layout;
+    }
+
+    static bool supports(const CompiledLayout& layout) { return layout.get_square_box() == Box; }
+
+    static constexpr int values() { return Layout::SIZE; }
+    // Zero for every cell
+    static CandidateCells make_candidates() { return CandidateCells{}; }
+    static ValueCells make_values() { return ValueCells{}; }
+    static const auto& active_cells() { return Layout::tables.cells; }
+    static constexpr int active_cell_count() { return Layout::CELLS; }
+    static const auto& peers(int cell) { return Layout::tables.peers[cell]; }
+    static constexpr int region_count() { return Layout::REGIONS; }
+    static const auto& region(int region) { return Layout::tables.regions[region]; }
+};
+
+template <int Box>
+using FixedPropagation = BasicSinglePropagation<FixedTables<Box>>;
@@ -1,7 +1,113 @@
 #include "gcpuzzle.hpp"
 #include "gcsolver.hpp"
+#include "portfolio.hpp"
+
+namespace {
+    GcClues get_gc414wq_clues()
+    {
+        GcClues clues(GcPuzzle::GC_VERTICAL_CELL_COUNT, std::vector<int>(GcPuzzle::GC_HORIZONTAL_CELL_COUNT, GC_NO_CLUE));
+        clues[0][3] = 1;
+        clues[0][4] = 1;
+        clues[0][5] = 1;
+        clues[0][6] = 1;
+        clues[0][7] = 3;
+        clues[0][8] = 2;
+        clues[0][9] = 1;
+        clues[1][1] = 1;
+        clues[1][2] = 2;
+        clues[1][3] = 2;
+        clues[1][4] = 1;
+        clues[1][5] = 2;
+        clues[1][6] = 2;
+        clues[1][7] = 1;
+        clues[1][8] = 1;
+        clues[1][9] = 2;
+        clues[2][0] = 1;
+        clues[2][1] = 2;
+        clues[2][2] = 1;
+        clues[2][5] = 1;
+        clues[2][6] = 2;
+        clues[2][7] = 1;
+        clues[2][8] = 1;
+        clues[2][9] = 2;
+        clues[3][0] = 1;
+        clues[3][1] = 2;
+        clues[3][4] = 1;
+        clues[3][5] = 2;
+        clues[3][6] = 2;
+        clues[3][7] = 1;
+        clues[3][8] = 1;
+        clues[3][9] = 3;
+        clues[4][0] = 1;
+        clues[4][1] = 3;
+        clues[4][2] = 1;
+        clues[4][4] = 2;
+        clues[4][5] = 2;
+        clues[4][6] = 1;
+        clues[4][7] = 1;
+        clues[4][9] = 2;
+        clues[5][0] = 3;
+        clues[5][1] = 2;
+        clues[5][2] = 1;
+        clues[5][3] = 1;
+        clues[5][4] = 2;
+        clues[5][6] = 1;
+        clues[5][7] = 1;
+        clues[5][9] = 2;
+        clues[6][0] = 1;
+        clues[6][1] = 1;
+        clues[6][2] = 3;
+        clues[6][3] = 2;
+        clues[6][4] = 2;
+        clues[6][5] = 1;
+        clues[6][6] = 2;
+        clues[6][7] = 1;
+        clues[6][8] = 1;
+        clues[6][9] = 2;
+        clues[7][1] = 1;
+        clues[7][2] = 2;
+        clues[7][3] = 1;
+        clues[7][4] = 1;
+        clues[7][5] = 1;
+        clues[7][6] = 2;
+        clues[7][8] = 2;
+        clues[7][9] = 1;
+        clues[8][1] = 2;
+        clues[8][2] = 1;
+        clues[8][3] = 2;
+        clues[8][5] = 1;
+        clues[8][6] = 3;
+        clues[8][7] = 2;
+        clues[8][8] = 2;
+        clues[8][9] = 2;
+        clues[9][0] = 1;
+        clues[9][1] = 2;
+        clues[9][5] = 2;
+        clues[9][6] = 2;
+        clues[9][7] = 3;
+        clues[9][8] = 1;
+        clues[9][9] = 3;
+        clues[10][0] = 1;
+        clues[10][1] = 2;
+        clues[10][2] = 1;
+        clues[10][3] = 1;
+        clues[10][4] = 2;
+        clues[10][5] = 2;
+        clues[10][7] = 1;
+        return clues;
+    }
+}
 
 GcPuzzle::GcPuzzle()
+    : m_clues(get_gc414wq_clues())
+    // The lines of this puzzle have loose ends, it has no single loop solution
+    , m_single_loop(false)
+{
+}
+
+GcPuzzle::GcPuzzle(const GcClues& clues, bool single_loop)
+    : m_clues(clues)
+    , m_single_loop(single_loop)
 {
 }
 
@@ -10,27 +116,138 @@ GcPuzzle::~GcPuzzle()
 
 }
 
+void GcPuzzle::set_solver_options(const Settings::SolverOptions& solver_options)
+{
+    m_solver_options = solver_options;
+}
+
+int GcPuzzle::get_rows() const
+{
+    return m_clues.size();
+}
+
+int GcPuzzle::get_columns() const
+{
+    return m_clues.empty() ? 0 : m_clues.front().size();
+}
+
+const GcClues& GcPuzzle::get_clues() const
+{
+    return m_clues;
+}
+
+GcBoard GcPuzzle::get_empty_board() const
+{
+    GcBoard board;
+    board.horizontal_lines.assign(get_rows() + 1, std::vector<bool>(get_columns(), false));
+    board.vertical_lines.assign(get_columns() + 1, std::vector<bool>(get_rows(), false));
+    return board;
+}
+
+std::vector<std::string> GcPuzzle::draw(const GcBoard& board) const
+{
+    std::vector<std::string> lines;
+    for (size_t row = 0; row <= m_clues.size(); ++row)
+    {
+        std::string corners = "+";
+        for (bool segment : board.horizontal_lines[row])
+        {
+            corners += segment ? "-+" : " +";
+        }
+        lines.push_back(corners);
+        if (row == m_clues.size())
+        {
+            break;
+        }
+        std::string cells;
+        for (size_t column = 0; column <= m_clues[row].size(); ++column)
+        {
+            cells += board.vertical_lines[column][row] ? '|' : ' ';
+            if (column < m_clues[row].size())
+            {
+                cells += (m_clues[row][column] == GC_NO_CLUE) ? ' ' : static_cast<char>('0' + m_clues[row][column]);
+            }
+        }
+        lines.push_back(cells);
+    }
+    return lines;
+}
+
 bool GcPuzzle::apply_board(const GcBoard& board)
 {
     GcSolverSettings settings;
-    settings.horizontal_line_count = GC_HORIZONTAL_LINE_COUNT;
-    settings.horizontal_cell_count = GC_HORIZONTAL_CELL_COUNT;
-    settings.vertical_line_count = GC_VERTICAL_LINE_COUNT;
-    settings.vertical_cell_count = GC_VERTICAL_CELL_COUNT;
-    m_solver = std::make_unique<GcSolver>(settings);
-    return m_solver->apply_board(board);
+    settings.horizontal_line_count = get_rows() + 1;
+    settings.horizontal_cell_count = get_columns();
+    settings.vertical_line_count = get_columns() + 1;
+    settings.vertical_cell_count = get_rows();
+    settings.clues = m_clues;
+    settings.single_loop = m_single_loop;
+    m_portfolio = std::make_unique<Portfolio<GcSolver>>();
+    bool consistent = true;
+    for (const auto& options : portfolio_options(m_solver_options))
+    {
+        auto solver = std::make_unique<GcSolver>(settings, options);
+        consistent = solver->apply_board(board) && consistent;
+        m_portfolio->add(std::move(solver));
+    }
+    // Only the first solver reports its progress
+    m_portfolio->get_solvers().front()->set_progress_callback(m_progress_callback);
+    return consistent;
 }
 
 bool GcPuzzle::solve()
 {
-    if (!m_solver)
-        return false;
-    return m_solver->solve();
+    return solve_limited(Settings::SolveLimits()) == SolveResult::SAT;
+}
+
+SolveResult GcPuzzle::solve_limited(const Settings::SolveLimits& limits)
+{
+    if (!m_portfolio)
+        return SolveResult::UNSAT;
+    return m_portfolio->solve_limited(limits);
+}
+
+int GcPuzzle::count_solutions(int limit)
+{
+    if (!m_portfolio)
+        return 0;
+    return m_portfolio->count_solutions(limit);
+}
+
+bool GcPuzzle::is_unique()
+{
+    return count_solutions(2) == 1;
 }
 
 GcBoard GcPuzzle::get_solution() const
 {
-    if (!m_solver)
+    if (!m_portfolio)
         return GcBoard();
-    return m_solver->get_solution();
+    return m_portfolio->get_winner().get_solution();
+}
+
+SolverStats GcPuzzle::get_stats() const
+{
+    if (!m_portfolio)
+        return SolverStats();
+    return m_portfolio->get_winner().get_stats();
+}
+
+void GcPuzzle::set_progress_callback(ProgressCallback callback)
+{
+    m_progress_callback = callback;
+    if (m_portfolio)
+        m_portfolio->get_solvers().front()->set_progress_callback(m_progress_callback);
+}
+
+void GcPuzzle::interrupt()
+{
+    if (m_portfolio)
+        m_portfolio->interrupt();
+}
+
+void GcPuzzle::clear_interrupt()
+{
+    if (m_portfolio)
+        m_portfolio->clear_interrupt();
 }
@@ -1,9 +1,15 @@
 #pragma once
 
 #include "puzzle_types.hpp"
+#include "solver_options.hpp"
+#include "solver_stats.hpp"
 #include <memory>
+#include <string>
+#include <vector>
 
 class GcSolver;
+template<class Solver>
+class Portfolio;
 
 class GcPuzzle
 {
@@ -13,13 +19,55 @@ public:
     static const int GC_HORIZONTAL_LINE_COUNT = GC_VERTICAL_CELL_COUNT + 1;
     static const int GC_VERTICAL_LINE_COUNT = GC_HORIZONTAL_CELL_COUNT + 1;
 
+    // The GC414WQ puzzle
     GcPuzzle();
+    // A puzzle of any size with a number of segments for some of the cells.
+    // With single_loop the solution is one closed loop, as in slitherlink.
+    GcPuzzle(const GcClues& clues, bool single_loop = true);
     virtual ~GcPuzzle();
+
+    // Number of rows and columns of cells
+    int get_rows() const;
+    int get_columns() const;
+    const GcClues& get_clues() const;
+    // A board of the size of the puzzle without any segments
+    GcBoard get_empty_board() const;
+    // Draws the segments of the board and the clues as text, one string per
+    // line:
+    //
+    //  +-+-+
+    //  |3 2|
+    //  +-+ +
+    std::vector<std::string> draw(const GcBoard& board) const;
+
+    // Selects the encoding options used by the following apply_board. With a
+    // portfolio_size above one, solve races that many solvers.
+    void set_solver_options(const Settings::SolverOptions& solver_options);
     bool apply_board(const GcBoard& board);
     // Returns true if the puzzle has a solution
     bool solve();
+    // Like solve, but gives up with UNKNOWN once one of the limits is reached,
+    // so one hard board cannot block the caller indefinitely
+    SolveResult solve_limited(const Settings::SolveLimits& limits);
+    // Returns the number of solutions of the applied board, up to limit
+    int count_solutions(int limit);
+    // Returns true if the applied board has exactly one solution
+    bool is_unique();
     GcBoard get_solution() const;
+    // Returns the statistics of the last apply_board and solve
+    SolverStats get_stats() const;
+    // The callback is called now and then during solve and count_solutions
+    void set_progress_callback(ProgressCallback callback);
+    // Stops a running solve or count_solutions from another thread. An
+    // interrupt between solves stops the next one.
+    void interrupt();
+    // Drops an interrupt that arrived between solves
+    void clear_interrupt();
 
 private:
-    std::unique_ptr<GcSolver> m_solver;
+    GcClues m_clues;
+    bool m_single_loop;
+    Settings::SolverOptions m_solver_options;
+    ProgressCallback m_progress_callback;
+    std::unique_ptr<Portfolio<GcSolver>> m_portfolio;
 };
@@ -1,37 +1,11 @@
 #include "gcsolver.hpp"
+#include "cardinality.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <numeric>
 
 namespace {
-PointVector getMinibox(int row, int column, int size)
-{
-    PointVector points;
-    for (int rr = 0; rr < size; ++rr) {
-        for (int cc = 0; cc < size; ++cc) {
-            points.emplace_back(row + rr, column + cc);
-        }
-    }
-    return points;
-}
-
-PointVector getHorizontalRegion(int row, int column, int size)
-{
-    PointVector points;
-    for (int cc = 0; cc < size; ++cc) {
-        points.emplace_back(row, column + cc);
-    }
-    return points;
-}
-
-PointVector getVerticalRegion(int row, int column, int size)
-{
-    PointVector points;
-    for (int rr = 0; rr < size; ++rr) {
-        points.emplace_back(row + rr, column);
-    }
-    return points;
-}
-
 void log_var(Minisat::Lit lit) {
     if (sign(lit)) {
         std::clog << '-';
@@ -50,109 +24,20 @@ void log_clause(Minisat::Lit lhs, Minisat::Lit rhs) {
     log_var(lhs); log_var(rhs);
     std::clog << "0\n";
 }
-
-const int UNSPECIFIED_ADJACENTS = 5;
 } //end anonymous namespace
 
-GcSolver::GcSolver(GcSolverSettings solver_settings, bool write_dimacs)
+GcSolver::GcSolver(GcSolverSettings solver_settings, Settings::SolverOptions solver_options, bool write_dimacs)
     : m_solver_settings(solver_settings)
     , m_write_dimacs(write_dimacs)
+    , m_solver_options(solver_options)
+    , m_solver(create_sat_backend(m_solver_options))
 {
-    m_adjacents.resize(m_solver_settings.vertical_cell_count, std::vector<int>(m_solver_settings.horizontal_cell_count, UNSPECIFIED_ADJACENTS));
-    m_adjacents[0][3] = 1;
-    m_adjacents[0][4] = 1;
-    m_adjacents[0][5] = 1;
-    m_adjacents[0][6] = 1;
-    m_adjacents[0][7] = 3;
-    m_adjacents[0][8] = 2;
-    m_adjacents[0][9] = 1;
-    m_adjacents[1][1] = 1;
-    m_adjacents[1][2] = 2;
-    m_adjacents[1][3] = 2;
-    m_adjacents[1][4] = 1;
-    m_adjacents[1][5] = 2;
-    m_adjacents[1][6] = 2;
-    m_adjacents[1][7] = 1;
-    m_adjacents[1][8] = 1;
-    m_adjacents[1][9] = 2;
-    m_adjacents[2][0] = 1;
-    m_adjacents[2][1] = 2;
-    m_adjacents[2][2] = 1;
-    m_adjacents[2][5] = 1;
-    m_adjacents[2][6] = 2;
-    m_adjacents[2][7] = 1;
-    m_adjacents[2][8] = 1;
-    m_adjacents[2][9] = 2;
-    m_adjacents[3][0] = 1;
-    m_adjacents[3][1] = 2;
-    m_adjacents[3][4] = 1;
-    m_adjacents[3][5] = 2;
-    m_adjacents[3][6] = 2;
-    m_adjacents[3][7] = 1;
-    m_adjacents[3][8] = 1;
-    m_adjacents[3][9] = 3;
-    m_adjacents[4][0] = 1;
-    m_adjacents[4][1] = 3;
-    m_adjacents[4][2] = 1;
-    m_adjacents[4][4] = 2;
-    m_adjacents[4][5] = 2;
-    m_adjacents[4][6] = 1;
-    m_adjacents[4][7] = 1;
-    m_adjacents[4][9] = 2;
-    m_adjacents[5][0] = 3;
-    m_adjacents[5][1] = 2;
-    m_adjacents[5][2] = 1;
-    m_adjacents[5][3] = 1;
-    m_adjacents[5][4] = 2;
-    m_adjacents[5][6] = 1;
-    m_adjacents[5][7] = 1;
-    m_adjacents[5][9] = 2;
-    m_adjacents[6][0] = 1;
-    m_adjacents[6][1] = 1;
-    m_adjacents[6][2] = 3;
-    m_adjacents[6][3] = 2;
-    m_adjacents[6][4] = 2;
-    m_adjacents[6][5] = 1;
-    m_adjacents[6][6] = 2;
-    m_adjacents[6][7] = 1;
-    m_adjacents[6][8] = 1;
-    m_adjacents[6][9] = 2;
-    m_adjacents[7][1] = 1;
-    m_adjacents[7][2] = 2;
-    m_adjacents[7][3] = 1;
-    m_adjacents[7][4] = 1;
-    m_adjacents[7][5] = 1;
-    m_adjacents[7][6] = 2;
-    m_adjacents[7][8] = 2;
-    m_adjacents[7][9] = 1;
-    m_adjacents[8][1] = 2;
-    m_adjacents[8][2] = 1;
-    m_adjacents[8][3] = 2;
-    m_adjacents[8][5] = 1;
-    m_adjacents[8][6] = 3;
-    m_adjacents[8][7] = 2;
-    m_adjacents[8][8] = 2;
-    m_adjacents[8][9] = 2;
-    m_adjacents[9][0] = 1;
-    m_adjacents[9][1] = 2;
-    m_adjacents[9][5] = 2;
-    m_adjacents[9][6] = 2;
-    m_adjacents[9][7] = 3;
-    m_adjacents[9][8] = 1;
-    m_adjacents[9][9] = 3;
-    m_adjacents[10][0] = 1;
-    m_adjacents[10][1] = 2;
-    m_adjacents[10][2] = 1;
-    m_adjacents[10][3] = 1;
-    m_adjacents[10][4] = 2;
-    m_adjacents[10][5] = 2;
-    m_adjacents[10][7] = 1;
-
+    ScopedTimer timer(m_stats.encode_ms);
     init_variables();
     add_clauses_for_segments_surrounding_cells();
     add_clauses_for_corners();
-    // TODO: Add clauses to enforce a single closed structur
-    // An intermediate step might be enforcing 0 or 2 lines on every crossing
+    // A single closed loop is enforced lazily by solve_single_loop, on top of
+    // none or two segments on every interior corner
 }
 
 Minisat::Var GcSolver::toVar(int line, int segment, bool horizontal)  const{
@@ -202,7 +87,9 @@ void GcSolver::init_variables() {
     }
     for (int l = 0; l < m_solver_settings.horizontal_line_count; ++l) {
         for (int s = 0; s < m_solver_settings.horizontal_cell_count; ++s) {
-            auto var = m_solver.newVar();
+            auto var = m_solver->new_var();
+            // Loops are read from the model and cut by clauses over segments
+            m_solver->freeze(var);
             if (m_write_dimacs) {
                 std::clog << "c (" << l << ", " << s << ") = " << var + 1 << '\n';
             }
@@ -214,12 +101,36 @@ void GcSolver::init_variables() {
     }
     for (int l = 0; l < m_solver_settings.vertical_line_count; ++l) {
         for (int s = 0; s < m_solver_settings.vertical_cell_count; ++s) {
-            auto var = m_solver.newVar();
+            auto var = m_solver->new_var();
+            m_solver->freeze(var);
             if (m_write_dimacs) {
                 std::clog << "c (" << l << ", " << s << ") = " << var + 1 << '\n';
             }
         }
     }
+    const int segment_count = m_solver->get_stats().variables;
+    m_given_segments.assign(segment_count, false);
+
+    // Corners are numbered row by row, a row has a corner per vertical line
+    const int corners_per_row = m_solver_settings.vertical_line_count;
+    m_segment_corners.resize(segment_count);
+    for (int l = 0; l < m_solver_settings.horizontal_line_count; ++l) {
+        for (int s = 0; s < m_solver_settings.horizontal_cell_count; ++s) {
+            m_segment_corners[toVar(l, s, true)] = {l * corners_per_row + s, l * corners_per_row + s + 1};
+        }
+    }
+    for (int l = 0; l < m_solver_settings.vertical_line_count; ++l) {
+        for (int s = 0; s < m_solver_settings.vertical_cell_count; ++s) {
+            m_segment_corners[toVar(l, s, false)] = {s * corners_per_row + l, (s + 1) * corners_per_row + l};
+        }
+    }
+    const int corner_count = m_solver_settings.horizontal_line_count * corners_per_row;
+    m_corner_segments.resize(corner_count);
+    for (Minisat::Var segment = 0; segment < segment_count; ++segment) {
+        m_corner_segments[m_segment_corners[segment].first].push_back(segment);
+        m_corner_segments[m_segment_corners[segment].second].push_back(segment);
+    }
+    m_on_loop.assign(corner_count, false);
 
     std::clog << std::flush;
 }
@@ -230,14 +141,14 @@ void GcSolver::add_clauses_for_segments_surrounding_cells()
     {
         for (int col = 0; col< m_solver_settings.horizontal_cell_count; ++col)
         {
-            if (m_adjacents[row][col] != UNSPECIFIED_ADJACENTS)
+            if (m_solver_settings.clues[row][col] != GC_NO_CLUE)
             {
                 Minisat::vec<Minisat::Lit> literals;
                 literals.push(Minisat::mkLit(toVar(row, col, true)));
                 literals.push(Minisat::mkLit(toVar(row + 1, col, true)));
                 literals.push(Minisat::mkLit(toVar(col, row, false)));
                 literals.push(Minisat::mkLit(toVar(col + 1, row, false)));
-                switch(m_adjacents[row][col])
+                switch(m_solver_settings.clues[row][col])
                 {
                 case 0:
                     none_true(literals);
@@ -301,6 +212,10 @@ void GcSolver::add_clauses_for_corners()
         literals.push(Minisat::mkLit(toVar(row, m_solver_settings.horizontal_cell_count - 1, true)));
         none_or_two(literals);
     }
+    if (!m_solver_settings.single_loop)
+    {
+        return;
+    }
     for (size_t row=1; row < m_solver_settings.vertical_cell_count; ++row)
     {
         for(size_t col=1; col < m_solver_settings.horizontal_cell_count; ++col)
@@ -310,7 +225,7 @@ void GcSolver::add_clauses_for_corners()
             literals.push(Minisat::mkLit(toVar(row, col, true)));
             literals.push(Minisat::mkLit(toVar(col, row - 1, false)));
             literals.push(Minisat::mkLit(toVar(col, row, false)));
-            //none_or_two(literals);
+            none_or_two(literals);
         }
     }
 }
@@ -322,8 +237,8 @@ void GcSolver::none_or_two(Minisat::vec<Minisat::Lit> const& literals) {
             log_clause( literals[0], ~literals[1]);
             log_clause(~literals[0],  literals[1]);
         }
-        m_solver.addClause( literals[0], ~literals[1]);
-        m_solver.addClause(~literals[0],  literals[1]);
+        m_solver->add_clause( literals[0], ~literals[1]);
+        m_solver->add_clause(~literals[0],  literals[1]);
     }
     else if (literals.size() == 3)
     {
@@ -334,7 +249,7 @@ void GcSolver::none_or_two(Minisat::vec<Minisat::Lit> const& literals) {
         if (m_write_dimacs) {
             log_clause(inv_literals);
         }
-        m_solver.addClause(inv_literals);
+        m_solver->add_clause(inv_literals);
         Minisat::vec<Minisat::Lit> current_literals;
         current_literals.push(~literals[0]);
         current_literals.push( literals[1]);
@@ -342,7 +257,7 @@ void GcSolver::none_or_two(Minisat::vec<Minisat::Lit> const& literals) {
         if (m_write_dimacs) {
             log_clause(current_literals);
         }
-        m_solver.addClause(current_literals);
+        m_solver->add_clause(current_literals);
         current_literals.clear();
         current_literals.push( literals[0]);
         current_literals.push(~literals[1]);
@@ -350,7 +265,7 @@ void GcSolver::none_or_two(Minisat::vec<Minisat::Lit> const& literals) {
         if (m_write_dimacs) {
             log_clause(current_literals);
         }
-        m_solver.addClause(current_literals);
+        m_solver->add_clause(current_literals);
         current_literals.clear();
         current_literals.push( literals[0]);
         current_literals.push( literals[1]);
@@ -358,7 +273,7 @@ void GcSolver::none_or_two(Minisat::vec<Minisat::Lit> const& literals) {
         if (m_write_dimacs) {
             log_clause(current_literals);
         }
-        m_solver.addClause(current_literals);
+        m_solver->add_clause(current_literals);
     }
     else if (literals.size() == 4)
     {
@@ -370,7 +285,7 @@ void GcSolver::none_or_two(Minisat::vec<Minisat::Lit> const& literals) {
         if (m_write_dimacs) {
             log_clause(inv_literals);
         }
-        m_solver.addClause(inv_literals);
+        m_solver->add_clause(inv_literals);
         for (size_t i=0; i<literals.size(); ++i)
         {
             Minisat::vec<Minisat::Lit> current_literals;
@@ -392,8 +307,8 @@ void GcSolver::none_or_two(Minisat::vec<Minisat::Lit> const& literals) {
                 log_clause(current_literals);
                 log_clause(current_inv_literals);
             }
-            m_solver.addClause(current_literals);
-            m_solver.addClause(current_inv_literals);
+            m_solver->add_clause(current_literals);
+            m_solver->add_clause(current_inv_literals);
         }
     }
 }
@@ -403,23 +318,12 @@ void GcSolver::none_true(Minisat::vec<Minisat::Lit> const& literals) {
         if (m_write_dimacs) {
             log_var(~literals[i]);
         }
-        m_solver.addClause(~literals[i]);
+        m_solver->add_clause(~literals[i]);
     }
 }
 
 void GcSolver::exactly_one_true(Minisat::vec<Minisat::Lit> const& literals) {
-    if (m_write_dimacs) {
-        log_clause(literals);
-    }
-    m_solver.addClause(literals);
-    for (size_t i = 0; i < literals.size(); ++i) {
-        for (size_t j = i + 1; j < literals.size(); ++j) {
-            if (m_write_dimacs) {
-                log_clause(~literals[i], ~literals[j]);
-            }
-            m_solver.addClause(~literals[i], ~literals[j]);
-        }
-    }
+    Cardinality::exactly_one(*m_solver, literals, m_solver_options.amo_encoding, m_write_dimacs);
 }
 
 void GcSolver::exactly_two_true(Minisat::vec<Minisat::Lit> const& literals) {
@@ -443,8 +347,8 @@ void GcSolver::exactly_two_true(Minisat::vec<Minisat::Lit> const& literals) {
             log_clause(current_literals);
             log_clause(current_inv_literals);
         }
-        m_solver.addClause(current_literals);
-        m_solver.addClause(current_inv_literals);
+        m_solver->add_clause(current_literals);
+        m_solver->add_clause(current_inv_literals);
     }
 }
 
@@ -458,27 +362,29 @@ void GcSolver::exactly_three_true(Minisat::vec<Minisat::Lit> const& literals) {
     if (m_write_dimacs) {
         log_clause(inv_literals);
     }
-    m_solver.addClause(inv_literals);
+    m_solver->add_clause(inv_literals);
 
     for (size_t i = 0; i < literals.size(); ++i) {
         for (size_t j = i + 1; j < literals.size(); ++j) {
             if (m_write_dimacs) {
                 log_clause(literals[i], literals[j]);
             }
-            m_solver.addClause(literals[i], literals[j]);
+            m_solver->add_clause(literals[i], literals[j]);
         }
     }
 }
 
 bool GcSolver::apply_board(const GcBoard& b) {
     assert(is_valid(b) && "Provided board is not valid!");
+    ScopedTimer timer(m_stats.apply_ms);
     bool ret = true;
     bool is_horizontal = true;
     for (int l = 0; l < m_solver_settings.horizontal_line_count; ++l) {
         for (int s = 0; s < m_solver_settings.horizontal_cell_count; ++s) {
             if (b.horizontal_lines[l][s])
             {
-                ret &= m_solver.addClause(Minisat::mkLit(toVar(l, s, is_horizontal)));
+                ret &= m_solver->add_clause(Minisat::mkLit(toVar(l, s, is_horizontal)));
+                m_given_segments[toVar(l, s, is_horizontal)] = true;
             }
         }
     }
@@ -487,7 +393,8 @@ bool GcSolver::apply_board(const GcBoard& b) {
         for (int s = 0; s < m_solver_settings.vertical_cell_count; ++s) {
             if (b.vertical_lines[l][s])
             {
-                ret &= m_solver.addClause(Minisat::mkLit(toVar(l, s, is_horizontal)));
+                ret &= m_solver->add_clause(Minisat::mkLit(toVar(l, s, is_horizontal)));
+                m_given_segments[toVar(l, s, is_horizontal)] = true;
             }
         }
     }
@@ -495,7 +402,134 @@ bool GcSolver::apply_board(const GcBoard& b) {
 }
 
 bool GcSolver::solve() {
-    return m_solver.solve();
+    return solve_limited(Settings::SolveLimits()) == SolveResult::SAT;
+}
+
+SolveResult GcSolver::solve_limited(Settings::SolveLimits const& limits) {
+    SolveControl::Interrupter::Scope interrupt_scope(m_interrupter);
+    SolveStatsRecorder<SatBackend> recorder(*m_solver, m_stats);
+    // The limits hold for all rounds of subtour clauses together
+    const SolveControl::Budget budget(*m_solver, limits);
+    Minisat::vec<Minisat::Lit> no_assumptions;
+    const Minisat::lbool result = solve_single_loop(no_assumptions, recorder.report_to(m_progress_callback), budget);
+    return SolveControl::to_solve_result(result);
+}
+
+Minisat::lbool GcSolver::solve_single_loop(Minisat::vec<Minisat::Lit> const& assumptions, std::function<void()> const& on_progress,
+                                           SolveControl::Budget const& budget) {
+    // Every corner has none or two segments, so the model is a set of closed
+    // loops. Connectivity is only added for the loops that actually show up.
+    Minisat::lbool result = SolveControl::solve(*m_solver, assumptions, m_interrupter.interrupted(), on_progress, budget);
+    while (m_solver_settings.single_loop && result.isTrue()) {
+        auto loops = find_loops();
+        if (loops.size() <= 1) {
+            break;
+        }
+        for (size_t i = 0; i < loops.size(); ++i) {
+            add_subtour_clause(loops[i], loops[(i + 1) % loops.size()].front());
+        }
+        result = SolveControl::solve(*m_solver, assumptions, m_interrupter.interrupted(), on_progress, budget);
+    }
+    return result;
+}
+
+std::vector<std::vector<Minisat::Var>> GcSolver::find_loops() const {
+    const int segment_count = m_segment_corners.size();
+    std::vector<int> parent(m_corner_segments.size());
+    std::iota(parent.begin(), parent.end(), 0);
+    auto find_root = [&parent](int corner) {
+        while (parent[corner] != corner) {
+            parent[corner] = parent[parent[corner]];
+            corner = parent[corner];
+        }
+        return corner;
+    };
+    for (Minisat::Var segment = 0; segment < segment_count; ++segment) {
+        if (m_solver->model_value(segment).isTrue()) {
+            parent[find_root(m_segment_corners[segment].first)] = find_root(m_segment_corners[segment].second);
+        }
+    }
+
+    std::vector<std::vector<Minisat::Var>> loops;
+    std::vector<int> loop_of_root(parent.size(), -1);
+    for (Minisat::Var segment = 0; segment < segment_count; ++segment) {
+        if (m_solver->model_value(segment).isTrue()) {
+            const int root = find_root(m_segment_corners[segment].first);
+            if (loop_of_root[root] < 0) {
+                loop_of_root[root] = loops.size();
+                loops.emplace_back();
+            }
+            loops[loop_of_root[root]].push_back(segment);
+        }
+    }
+    return loops;
+}
+
+void GcSolver::add_subtour_clause(std::vector<Minisat::Var> const& loop, Minisat::Var other_segment) {
+    // The other segment does not touch the loop. When both are on, the single
+    // loop through both of them needs a segment with one corner on the loop.
+    std::vector<int> corners;
+    for (Minisat::Var segment : loop) {
+        corners.push_back(m_segment_corners[segment].first);
+        corners.push_back(m_segment_corners[segment].second);
+    }
+    std::sort(corners.begin(), corners.end());
+    corners.erase(std::unique(corners.begin(), corners.end()), corners.end());
+    for (int corner : corners) {
+        m_on_loop[corner] = true;
+    }
+    Minisat::vec<Minisat::Lit> literals;
+    literals.push(~Minisat::mkLit(loop.front()));
+    literals.push(~Minisat::mkLit(other_segment));
+    for (int corner : corners) {
+        for (Minisat::Var segment : m_corner_segments[corner]) {
+            if (!m_on_loop[m_segment_corners[segment].first] || !m_on_loop[m_segment_corners[segment].second]) {
+                literals.push(Minisat::mkLit(segment));
+            }
+        }
+    }
+    for (int corner : corners) {
+        m_on_loop[corner] = false;
+    }
+    if (m_write_dimacs) {
+        log_clause(literals);
+    }
+    m_solver->add_clause(literals);
+}
+
+int GcSolver::count_solutions(int limit) {
+    SolveControl::Interrupter::Scope interrupt_scope(m_interrupter);
+    SolveStatsRecorder<SatBackend> recorder(*m_solver, m_stats);
+    // The blocking clauses only hold while the activation literal is assumed,
+    // so they can be retired afterwards.
+    const Minisat::Lit activation = Minisat::mkLit(m_solver->new_var());
+    const int segment_count = m_given_segments.size();
+    int count = 0;
+    Minisat::vec<Minisat::lbool> first_model;
+    Minisat::vec<Minisat::Lit> assumptions;
+    assumptions.push(activation);
+    const auto on_progress = recorder.report_to(m_progress_callback);
+    while ((count < limit) && solve_single_loop(assumptions, on_progress).isTrue()) {
+        if (count == 0) {
+            m_solver->model.copyTo(first_model);
+        }
+        ++count;
+        // Block the state of every segment that is not given
+        Minisat::vec<Minisat::Lit> blocking;
+        blocking.push(~activation);
+        for (Minisat::Var segment = 0; segment < segment_count; ++segment) {
+            if (!m_given_segments[segment]) {
+                blocking.push(Minisat::mkLit(segment, m_solver->model_value(segment).isTrue()));
+            }
+        }
+        m_solver->add_clause(blocking);
+    }
+    m_solver->add_clause(~activation);
+    // Later solves overwrote the model, get_solution should return the first
+    if (count > 0) {
+        first_model.moveTo(m_solver->model);
+    }
+    return count;
 }
 
 GcBoard GcSolver::get_solution() const {
@@ -506,14 +540,37 @@ GcBoard GcSolver::get_solution() const {
     bool is_horizontal = true;
     for (int l = 0; l < m_solver_settings.horizontal_line_count; ++l) {
         for (int s = 0; s < m_solver_settings.horizontal_cell_count; ++s) {
-            b.horizontal_lines[l][s] = m_solver.modelValue(toVar(l, s, is_horizontal)).isTrue();
+            b.horizontal_lines[l][s] = m_solver->model_value(toVar(l, s, is_horizontal)).isTrue();
         }
     }
     is_horizontal = false;
     for (int l = 0; l < m_solver_settings.vertical_line_count; ++l) {
         for (int s = 0; s < m_solver_settings.vertical_cell_count; ++s) {
-            b.vertical_lines[l][s] = m_solver.modelValue(toVar(l, s, is_horizontal)).isTrue();
+            b.vertical_lines[l][s] = m_solver->model_value(toVar(l, s, is_horizontal)).isTrue();
         }
     }
     return b;
 }
+
+SolverStats GcSolver::get_stats() const {
+    SolverStats stats = m_stats;
+    const SolverStats backend_stats = m_solver->get_stats();
+    stats.variables = backend_stats.variables;
+    stats.clauses = backend_stats.clauses;
+    stats.eliminated_variables = backend_stats.eliminated_variables;
+    stats.removed_clauses = backend_stats.removed_clauses;
+    stats.preprocess_ms = backend_stats.preprocess_ms;
+    return stats;
+}
+
+void GcSolver::set_progress_callback(ProgressCallback callback) {
+    m_progress_callback = callback;
+}
+
+void GcSolver::interrupt() {
+    m_interrupter.interrupt();
+}
+
+void GcSolver::clear_interrupt() {
+    m_interrupter.clear_interrupt();
+}
@@ -1,7 +1,11 @@
 #pragma once
 
 #include "puzzle_types.hpp"
-#include <minisat/core/Solver.h>
+#include "sat_backend.hpp"
+#include "solve_control.hpp"
+#include "solver_options.hpp"
+#include "solver_stats.hpp"
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -11,16 +15,35 @@ struct GcSolverSettings
     int horizontal_line_count;
     int vertical_cell_count;
     int vertical_line_count;
+    // vertical_cell_count rows of horizontal_cell_count clues
+    GcClues clues;
+    // The segments form one closed loop, as in slitherlink. Otherwise only
+    // the corners on the border are restricted to none or two segments.
+    bool single_loop = true;
 };
 
 class GcSolver {
 public:
-    GcSolver(GcSolverSettings solver_settings, bool write_dimacs = false);
+    GcSolver(GcSolverSettings solver_settings, Settings::SolverOptions solver_options = Settings::SolverOptions(), bool write_dimacs = false);
     // Returns true if the provided board satisfies the constraints
     bool apply_board(const GcBoard& board);
-    // Returns true if the gc puzzle has a solution
+    // Returns true if the gc puzzle has a solution with a single closed loop
     bool solve();
+    // Like solve, but gives up with UNKNOWN once one of the limits is reached
+    SolveResult solve_limited(Settings::SolveLimits const& limits);
+    // Returns the number of solutions, but stops counting at limit. After
+    // counting, get_solution returns the first solution that was found.
+    int count_solutions(int limit);
     GcBoard get_solution() const;
+    SolverStats get_stats() const;
+    // The callback is called now and then during solve and count_solutions
+    void set_progress_callback(ProgressCallback callback);
+    // Stops a running solve or count_solutions from another thread, which
+    // then report no (further) solutions. An interrupt between solves stops
+    // the next one.
+    void interrupt();
+    // Drops an interrupt that arrived between solves
+    void clear_interrupt();
 
 private:
     Minisat::Var toVar(int line, int segment, bool horizontal) const;
@@ -35,9 +58,29 @@ private:
     void exactly_three_true(Minisat::vec<Minisat::Lit> const& literals);
     void none_or_two(Minisat::vec<Minisat::Lit> const& literals);
 
+    // Solves until the model is a single loop, adding a subtour clause for
+    // every loop of a model with several loops
+    Minisat::lbool solve_single_loop(Minisat::vec<Minisat::Lit> const& assumptions, std::function<void()> const& on_progress,
+                                     SolveControl::Budget const& budget = SolveControl::Budget());
+    // Returns the segments of every loop in the model
+    std::vector<std::vector<Minisat::Var>> find_loops() const;
+    // Either segment is off, or a segment leaves the corners of the loop
+    void add_subtour_clause(std::vector<Minisat::Var> const& loop, Minisat::Var other_segment);
+
     const bool m_write_dimacs = false;
-    Minisat::Solver m_solver;
+    const Settings::SolverOptions m_solver_options;
+    const std::unique_ptr<SatBackend> m_solver;
 
     const GcSolverSettings m_solver_settings;
-    std::vector<std::vector<int>> m_adjacents;
+    // Segments that are forced by the applied board
+    std::vector<bool> m_given_segments;
+    // Corners at both ends of every segment
+    std::vector<std::pair<int, int>> m_segment_corners;
+    // Segments that end in every corner
+    std::vector<std::vector<Minisat::Var>> m_corner_segments;
+    // Marks the corners of a loop while building its subtour clause
+    std::vector<bool> m_on_loop;
+    SolverStats m_stats;
+    ProgressCallback m_progress_callback;
+    SolveControl::Interrupter m_interrupter{m_solver.get()};
 };
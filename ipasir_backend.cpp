@@ -0,0 +1,103 @@
+#include "ipasir_backend.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+// The interface as declared by the ipasir.h of the SAT competitions
+extern "C" {
+    const char* ipasir_signature();
+    void* ipasir_init();
+    void ipasir_release(void* solver);
+    void ipasir_add(void* solver, std::int32_t lit_or_zero);
+    void ipasir_assume(void* solver, std::int32_t lit);
+    int ipasir_solve(void* solver);
+    std::int32_t ipasir_val(void* solver, std::int32_t lit);
+    void ipasir_set_terminate(void* solver, void* data, int (*terminate)(void* data));
+}
+
+namespace {
+    // Results of ipasir_solve
+    const int SATISFIABLE = 10;
+    const int UNSATISFIABLE = 20;
+}
+
+std::int32_t IpasirBackend::to_ipasir(Minisat::Lit literal) {
+    // IPASIR numbers variables from 1 and negates literals by their sign
+    const std::int32_t variable = var(literal) + 1;
+    m_used_variables = std::max(m_used_variables, variable);
+    return sign(literal) ? -variable : variable;
+}
+
+IpasirBackend::IpasirBackend()
+    : m_solver(ipasir_init()) {
+    ipasir_set_terminate(m_solver, this, &IpasirBackend::terminate_callback);
+}
+
+IpasirBackend::~IpasirBackend() {
+    ipasir_release(m_solver);
+}
+
+const char* IpasirBackend::get_signature() {
+    return ipasir_signature();
+}
+
+int IpasirBackend::terminate_callback(void* data) {
+    const IpasirBackend* backend = static_cast<const IpasirBackend*>(data);
+    return (backend->m_interrupted || (backend->m_terminate && backend->m_terminate())) ? 1 : 0;
+}
+
+Minisat::Var IpasirBackend::new_var() {
+    // IPASIR creates variables when they are first used
+    return m_variables++;
+}
+
+bool IpasirBackend::add_clause(Minisat::vec<Minisat::Lit> const& literals) {
+    for (int i = 0; i < literals.size(); ++i) {
+        ipasir_add(m_solver, to_ipasir(literals[i]));
+    }
+    ipasir_add(m_solver, 0);
+    ++m_clauses;
+    return literals.size() > 0;
+}
+
+void IpasirBackend::freeze(Minisat::Var) {
+}
+
+Minisat::lbool IpasirBackend::solve_limited(Minisat::vec<Minisat::Lit> const& assumptions) {
+    for (int i = 0; i < assumptions.size(); ++i) {
+        ipasir_assume(m_solver, to_ipasir(assumptions[i]));
+    }
+    const int result = ipasir_solve(m_solver);
+    if (result == SATISFIABLE) {
+        model.growTo(m_variables);
+        for (Minisat::Var variable = 0; variable < m_variables; ++variable) {
+            // Variables the solver has never seen are left false
+            const bool value = (variable < m_used_variables) && (ipasir_val(m_solver, variable + 1) > 0);
+            model[variable] = value ? l_True : l_False;
+        }
+        return l_True;
+    }
+    return (result == UNSATISFIABLE) ? l_False : l_Undef;
+}
+
+void IpasirBackend::set_budget(std::int64_t, std::int64_t) {
+}
+
+void IpasirBackend::set_terminate(std::function<bool()> terminate) {
+    m_terminate = std::move(terminate);
+}
+
+void IpasirBackend::interrupt() {
+    m_interrupted = true;
+}
+
+void IpasirBackend::clear_interrupt() {
+    m_interrupted = false;
+}
+
+SolverStats IpasirBackend::get_stats() const {
+    SolverStats stats;
+    stats.variables = m_variables;
+    stats.clauses = m_clauses;
+    return stats;
+}
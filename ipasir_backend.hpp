@@ -0,0 +1,47 @@
+#pragma once
+
+#include "sat_backend.hpp"
+#include <atomic>
+#include <cstdint>
+
+// Any solver implementing the IPASIR interface of the SAT competitions, like
+// CaDiCaL, Glucose, Kissat or MiniSat itself. IPASIR has no search
+// statistics and no budgets, so the stats only hold the size of the
+// encoding and conflict and propagation limits have no effect. Deadlines and
+// interrupts go through the terminate callback. Only the clauses the
+// encoders add are counted.
+class IpasirBackend : public SatBackend {
+public:
+    IpasirBackend();
+    ~IpasirBackend() override;
+
+    Minisat::Var new_var() override;
+    bool add_clause(Minisat::vec<Minisat::Lit> const& literals) override;
+    using SatBackend::add_clause;
+    // IPASIR solvers keep every variable that is used later themselves
+    void freeze(Minisat::Var var) override;
+    Minisat::lbool solve_limited(Minisat::vec<Minisat::Lit> const& assumptions) override;
+    void set_budget(std::int64_t conflicts, std::int64_t propagations) override;
+    void set_terminate(std::function<bool()> terminate) override;
+    void interrupt() override;
+    void clear_interrupt() override;
+    SolverStats get_stats() const override;
+
+    // The name and version of the linked solver
+    static const char* get_signature();
+
+private:
+    IpasirBackend(const IpasirBackend&) = delete;
+    IpasirBackend& operator=(const IpasirBackend&) = delete;
+
+    static int terminate_callback(void* backend);
+    std::int32_t to_ipasir(Minisat::Lit literal);
+
+    void* const m_solver;
+    int m_variables = 0;
+    // Variables that occurred in a clause or assumption
+    std::int32_t m_used_variables = 0;
+    int m_clauses = 0;
+    std::function<bool()> m_terminate;
+    std::atomic<bool> m_interrupted{false};
+};
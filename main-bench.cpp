@@ -0,0 +1,324 @@
+#include "board_reader.hpp"
+#include "compiledlayout.hpp"
+#include "puzzle_loader.hpp"
+#include "sat_backend.hpp"
+#include "sudokuengine.hpp"
+#include "sudokusolver.hpp"
+
+#include <QDir>
+#include <QFile>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+#ifndef PUZZLE_BENCH_DATA_DIR
+#define PUZZLE_BENCH_DATA_DIR "."
+#endif
+
+namespace {
+
+using Clock = std::chrono::high_resolution_clock;
+
+enum Phase {
+    ENCODE,
+    APPLY,
+    SOLVE,
+    GET_SOLUTION,
+    PHASE_COUNT
+};
+
+const char* const PHASE_NAMES[PHASE_COUNT] = {"encode", "apply_board", "solve", "get_solution"};
+
+enum Effort {
+    CONFLICTS,
+    DECISIONS,
+    PROPAGATIONS,
+    RESTARTS,
+    ELIMINATED_VARIABLES,
+    REMOVED_CLAUSES,
+    EFFORT_COUNT
+};
+
+const char* const EFFORT_NAMES[EFFORT_COUNT] = {"conflicts", "decisions", "propagations", "restarts",
+                                                 "elim. vars", "elim. clauses"};
+
+struct BenchInput {
+    std::string name;
+    std::shared_ptr<const CompiledLayout> layout;
+    std::vector<SudokuBoard> boards;
+};
+
+struct PhaseTimes {
+    std::vector<double> times[PHASE_COUNT];
+    // Search effort of the solves, from the solver statistics
+    std::vector<double> effort[EFFORT_COUNT];
+    int unsolved = 0;
+};
+
+double elapsed_ms(Clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+/**
+ * Reads one board per line in the format of BoardReader, all of the same
+ * standard size. Returns false if the file cannot be read or contains an
+ * invalid board.
+ */
+bool read_line_boards(const std::string& file_name, BenchInput& input) {
+    std::ifstream in(file_name, std::ios::binary);
+    if (!in) {
+        std::clog << "Cannot open " << file_name << '\n';
+        return false;
+    }
+    input.name = file_name;
+    BoardReader reader(in);
+    SudokuBoard board;
+    BoardReader::Status status;
+    while ((status = reader.read(board)) != BoardReader::Status::END) {
+        if (status == BoardReader::Status::INVALID) {
+            std::clog << file_name << ": line " << (reader.get_line_index() + 1) << " has " << reader.get_error_message() << '\n';
+            return false;
+        }
+        input.boards.push_back(board);
+    }
+    // A file without boards keeps the 9x9 layout
+    Settings::Sudoku::Type type = Settings::Sudoku::Type::S9X9;
+    Settings::Sudoku::get_standard_type(reader.get_side(), type);
+    input.layout = CompiledLayout::get(type);
+    return true;
+}
+
+/**
+ * Loads the layout of a puzzle file. The board is its example when it has
+ * one, otherwise the empty board. Slitherlink puzzles are skipped, leaving
+ * the input without boards.
+ */
+bool read_puzzle_file(const std::string& file_name, BenchInput& input) {
+    QFile file(QString::fromStdString(file_name));
+    if (!file.open(QFile::ReadOnly | QFile::Text)) {
+        std::clog << "Cannot open " << file_name << '\n';
+        return false;
+    }
+    auto puzzle = PuzzleLoader::load_from_file(file);
+    if (!puzzle && file.seek(0) && PuzzleLoader::load_slitherlink_from_file(file)) {
+        std::clog << "Skipping slitherlink puzzle " << file_name << '\n';
+        return true;
+    }
+    if (!puzzle) {
+        std::clog << "Cannot load puzzle " << file_name << '\n';
+        return false;
+    }
+    input.name = file_name;
+    input.layout = puzzle->get_layout();
+    if (puzzle->has_example()) {
+        input.boards.push_back(puzzle->get_example());
+    } else {
+        input.boards.emplace_back(puzzle->get_rows(), puzzle->get_columns());
+    }
+    return true;
+}
+
+void bench_input(const BenchInput& input, int runs, Settings::Sudoku::Engine engine,
+                 const Settings::SolverOptions& solver_options, PhaseTimes& phase_times) {
+    for (int run = 0; run < runs; ++run) {
+        for (const auto& board : input.boards) {
+            auto start = Clock::now();
+            auto solver = create_sudoku_engine(engine, input.layout, solver_options);
+            phase_times.times[ENCODE].push_back(elapsed_ms(start));
+
+            start = Clock::now();
+            bool consistent = solver->apply_board(board);
+            phase_times.times[APPLY].push_back(elapsed_ms(start));
+
+            start = Clock::now();
+            bool solved = consistent && solver->solve();
+            phase_times.times[SOLVE].push_back(elapsed_ms(start));
+            if (consistent) {
+                const SolverStats stats = solver->get_stats();
+                phase_times.effort[CONFLICTS].push_back(stats.conflicts);
+                phase_times.effort[DECISIONS].push_back(stats.decisions);
+                phase_times.effort[PROPAGATIONS].push_back(stats.propagations);
+                phase_times.effort[RESTARTS].push_back(stats.restarts);
+                phase_times.effort[ELIMINATED_VARIABLES].push_back(stats.eliminated_variables);
+                phase_times.effort[REMOVED_CLAUSES].push_back(stats.removed_clauses);
+            }
+            if (!solved) {
+                ++phase_times.unsolved;
+                continue;
+            }
+
+            start = Clock::now();
+            auto solution = solver->get_solution();
+            phase_times.times[GET_SOLUTION].push_back(elapsed_ms(start));
+        }
+    }
+}
+
+// Nearest rank percentile of sorted times
+double percentile(const std::vector<double>& sorted_times, double p) {
+    if (sorted_times.empty()) {
+        return 0.0;
+    }
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * sorted_times.size()));
+    return sorted_times[std::max<size_t>(rank, 1) - 1];
+}
+
+void report_row(const char* name, std::vector<double>& samples) {
+    std::sort(samples.begin(), samples.end());
+    double total = 0.0;
+    for (double sample : samples) {
+        total += sample;
+    }
+    std::cout << "  " << std::left << std::setw(14) << name << std::right
+              << std::setw(11) << (samples.empty() ? 0.0 : total / samples.size())
+              << std::setw(11) << percentile(samples, 50)
+              << std::setw(11) << percentile(samples, 90)
+              << std::setw(11) << percentile(samples, 99)
+              << std::setw(11) << (samples.empty() ? 0.0 : samples.back()) << '\n';
+}
+
+void report_header(const char* name) {
+    std::cout << "  " << std::left << std::setw(14) << name << std::right;
+    for (const char* column : {"mean", "p50", "p90", "p99", "max"}) {
+        std::cout << std::setw(11) << column;
+    }
+    std::cout << '\n';
+}
+
+void report(const std::string& name, PhaseTimes& phase_times) {
+    std::cout << name << " (" << phase_times.times[ENCODE].size() << " solves";
+    if (phase_times.unsolved > 0) {
+        std::cout << ", " << phase_times.unsolved << " unsolved";
+    }
+    std::cout << ")\n";
+    report_header("phase (ms)");
+    std::cout << std::fixed << std::setprecision(4);
+    for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+        report_row(PHASE_NAMES[phase], phase_times.times[phase]);
+    }
+    report_header("effort");
+    std::cout << std::setprecision(1);
+    for (int effort = 0; effort < EFFORT_COUNT; ++effort) {
+        report_row(EFFORT_NAMES[effort], phase_times.effort[effort]);
+    }
+    std::cout.unsetf(std::ios::floatfield);
+}
+
+void print_usage(const char* program) {
+    std::clog << "Usage: " << program << " [--runs N] [--engine minisat|propagation] [--backend minisat|ipasir] [--portfolio K]\n"
+              << "       [--no-presolve] [--preprocess none|light|normal|heavy] [file...]\n"
+              << "  Times the encode, apply_board, solve and get_solution phases of every\n"
+              << "  board, N times (default 10), and reports the search effort of the\n"
+              << "  solves. Files ending in .xpuz are puzzle files, others hold one 9x9\n"
+              << "  board per line. Without files the benchmark uses\n"
+              << "  inputs/benchmark/top95.txt and the puzzles directory. --portfolio K\n"
+              << "  races K differently configured minisat solvers for every solve.\n"
+              << "  --backend ipasir times the IPASIR library the benchmark was built with,\n"
+              << "  which reports no search effort.\n"
+              << "  Presolving moves the minisat encoding into apply_board, where it only\n"
+              << "  covers the cells that propagation leaves open; --no-presolve encodes\n"
+              << "  the whole board up front. --preprocess lets minisat simplify the\n"
+              << "  encoding before the first solve, its effort lists the eliminated\n"
+              << "  variables and clauses.\n";
+}
+
+bool parse_preprocessing(const std::string& name, Settings::Preprocessing& preprocessing) {
+    static const std::map<std::string, Settings::Preprocessing> levels = { {"none", Settings::Preprocessing::NONE},
+                                                                           {"light", Settings::Preprocessing::LIGHT},
+                                                                           {"normal", Settings::Preprocessing::NORMAL},
+                                                                           {"heavy", Settings::Preprocessing::HEAVY},
+                                                                         };
+    if (levels.count(name) == 0) {
+        return false;
+    }
+    preprocessing = levels.at(name);
+    return true;
+}
+
+} // end anonymous namespace
+
+
+
+int main(int argc, char* argv[]) {
+    std::vector<std::string> args(argv + 1, argv + argc);
+    int runs = 10;
+    Settings::Sudoku::Engine engine = Settings::Sudoku::Engine::MINISAT;
+    Settings::SolverOptions solver_options;
+    std::vector<std::string> file_names;
+    for (size_t i = 0; i < args.size(); ++i) {
+        if ((args[i] == "--runs") && (i + 1 < args.size())) {
+            runs = std::stoi(args[++i]);
+        } else if ((args[i] == "--engine") && (i + 1 < args.size()) && (args[i + 1] == "minisat")) {
+            engine = Settings::Sudoku::Engine::MINISAT;
+            ++i;
+        } else if ((args[i] == "--engine") && (i + 1 < args.size()) && (args[i + 1] == "propagation")) {
+            engine = Settings::Sudoku::Engine::PROPAGATION;
+            ++i;
+        } else if ((args[i] == "--backend") && (i + 1 < args.size()) && (args[i + 1] == "minisat")) {
+            solver_options.backend = Settings::Backend::MINISAT;
+            ++i;
+        } else if ((args[i] == "--backend") && (i + 1 < args.size()) && (args[i + 1] == "ipasir")
+                   && is_sat_backend_available(Settings::Backend::IPASIR)) {
+            solver_options.backend = Settings::Backend::IPASIR;
+            ++i;
+        } else if ((args[i] == "--portfolio") && (i + 1 < args.size())) {
+            solver_options.portfolio_size = std::stoi(args[++i]);
+        } else if (args[i] == "--no-presolve") {
+            solver_options.presolve = false;
+        } else if ((args[i] == "--preprocess") && (i + 1 < args.size()) && parse_preprocessing(args[i + 1], solver_options.preprocessing)) {
+            ++i;
+        } else if (args[i][0] != '-') {
+            file_names.push_back(args[i]);
+        } else {
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (file_names.empty()) {
+        const std::string data_dir = PUZZLE_BENCH_DATA_DIR;
+        file_names.push_back(data_dir + "/inputs/benchmark/top95.txt");
+        QDir puzzle_dir(QString::fromStdString(data_dir + "/puzzles"));
+        for (const QString& entry : puzzle_dir.entryList(QStringList("*.xpuz"), QDir::Files, QDir::Name)) {
+            file_names.push_back((puzzle_dir.filePath(entry)).toStdString());
+        }
+    }
+
+    std::vector<BenchInput> inputs;
+    for (const auto& file_name : file_names) {
+        BenchInput input;
+        bool ends_with_xpuz = (file_name.size() > 5) && (file_name.compare(file_name.size() - 5, 5, ".xpuz") == 0);
+        if (!(ends_with_xpuz ? read_puzzle_file(file_name, input) : read_line_boards(file_name, input))) {
+            return 1;
+        }
+        if (!input.boards.empty()) {
+            inputs.push_back(std::move(input));
+        }
+    }
+
+    PhaseTimes all_phase_times;
+    for (const auto& input : inputs) {
+        PhaseTimes phase_times;
+        bench_input(input, runs, engine, solver_options, phase_times);
+        for (int phase = 0; phase < PHASE_COUNT; ++phase) {
+            all_phase_times.times[phase].insert(all_phase_times.times[phase].end(),
+                                                phase_times.times[phase].begin(), phase_times.times[phase].end());
+        }
+        for (int effort = 0; effort < EFFORT_COUNT; ++effort) {
+            all_phase_times.effort[effort].insert(all_phase_times.effort[effort].end(),
+                                                  phase_times.effort[effort].begin(), phase_times.effort[effort].end());
+        }
+        all_phase_times.unsolved += phase_times.unsolved;
+        report(input.name, phase_times);
+    }
+    if (inputs.size() > 1) {
+        report("all inputs", all_phase_times);
+    }
+    return all_phase_times.unsolved == 0 ? 0 : 2;
+}
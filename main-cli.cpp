@@ -1,15 +1,24 @@
+#include "board_archive.hpp"
+#include "board_reader.hpp"
+#include "gcpuzzle.hpp"
+#include "puzzle_loader.hpp"
+#include "sat_backend.hpp"
+#include "sudokubatchsolver.hpp"
+#include "sudokugenerator.hpp"
 #include "sudokupuzzle.hpp"
 
 #include <iostream>
+#include <fstream>
+#include <map>
 #include <string>
 #include <vector>
 #include <chrono>
+#include <random>
 
 
 
 namespace {
 
-
 /**
  * Input patterns:
  * [1-9] means that square has a digit assigned,
@@ -28,7 +37,7 @@ namespace {
  *
  */
 SudokuBoard read_board(std::istream& in) {
-    SudokuBoard parsed(9, std::vector<int>(9));
+    SudokuBoard parsed(9, 9);
     int lines = 1;
     std::string line;
     while (std::getline(in, line) && lines <= 9) {
@@ -54,34 +63,546 @@ SudokuBoard read_board(std::istream& in) {
     return parsed;
 }
 
+/**
+ * Escapes text for a JSON string: quotes and backslashes get a backslash,
+ * bytes below 0x20 are written as \u00XX.
+ */
+std::string json_escape(const std::string& text) {
+    static const char HEX_DIGITS[] = "0123456789abcdef";
+    std::string escaped;
+    escaped.reserve(text.size());
+    for (char c : text) {
+        const unsigned char byte = static_cast<unsigned char>(c);
+        if ((c == '"') || (c == '\\')) {
+            escaped += '\\';
+            escaped += c;
+        } else if (byte < 0x20) {
+            escaped += "\\u00";
+            escaped += HEX_DIGITS[byte >> 4];
+            escaped += HEX_DIGITS[byte & 0xf];
+        } else {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
 
-} // end anonymous namespace
+/**
+ * Writes the squares in row-major order: . for empty squares, 1-9 and
+ * A, B, ... for values above 9.
+ */
+std::string board_to_line(const SudokuBoard& board) {
+    std::string line;
+    for (Value square : board) {
+        if (square == 0) {
+            line += '.';
+        } else if (square <= 9) {
+            line += static_cast<char>('0' + square);
+        } else {
+            line += static_cast<char>('A' + square - 10);
+        }
+    }
+    return line;
+}
 
+void write_stats(std::ostream& out, const SolverStats& stats) {
+    out << "{\"variables\":" << stats.variables
+        << ",\"clauses\":" << stats.clauses
+        << ",\"conflicts\":" << stats.conflicts
+        << ",\"decisions\":" << stats.decisions
+        << ",\"propagations\":" << stats.propagations
+        << ",\"restarts\":" << stats.restarts
+        << ",\"eliminated_variables\":" << stats.eliminated_variables
+        << ",\"removed_clauses\":" << stats.removed_clauses
+        << ",\"preprocess_ms\":" << stats.preprocess_ms
+        << ",\"encode_ms\":" << stats.encode_ms
+        << ",\"apply_ms\":" << stats.apply_ms
+        << ",\"solve_ms\":" << stats.solve_ms << "}";
+}
 
+void write_result(std::ostream& out, int index, const SudokuBatchResult& result, int solution_limit, const SudokuBoard* board = nullptr) {
+    out << "{\"index\":" << index;
+    if (board) {
+        out << ",\"board\":\"" << json_escape(board_to_line(*board)) << "\"";
+    }
+    if (result.solved) {
+        out << ",\"status\":\"solved\",\"time_ms\":" << result.time_ms;
+        if (solution_limit > 1) {
+            out << ",\"solutions\":" << result.solutions;
+        }
+        out << ",\"stats\":";
+        write_stats(out, result.stats);
+        out << ",\"solution\":\"" << json_escape(board_to_line(result.solution)) << "\"}\n";
+    } else {
+        out << ",\"status\":\"" << (result.consistent ? "unsolvable" : "contradiction") << "\""
+            << ",\"time_ms\":" << result.time_ms;
+        if (result.consistent) {
+            out << ",\"stats\":";
+            write_stats(out, result.stats);
+        }
+        out << "}\n";
+    }
+}
 
-int main() {
-    try {
-        auto board = read_board(std::cin);
+/**
+ * Solves every board of the input, one board per line in the format of
+ * BoardReader, writing one JSON object per line to out:
+ *
+ *  {"index":0,"status":"solved","time_ms":1.23,"stats":{...},"solution":"7264..."}
+ *
+ * The first board selects the layout: 9x9, 16x16 or 25x25 squares. Lines
+ * with another number of squares are invalid.
+ *
+ * status is one of solved, unsolvable, contradiction or invalid (the latter
+ * with an extra "error" member). Empty lines are skipped, but still counted
+ * in index so it matches the line number (zero based) of the input.
+ *
+ * stats holds the size of the encoding, the search effort (conflicts,
+ * decisions, propagations and restarts), what preprocessing removed from the
+ * encoding and the encode, apply and solve times of the solver, see
+ * SolverStats. It is left out for contradictions.
+ *
+ * With a solution limit above one, solved boards also get a "solutions" member
+ * with the number of solutions found, up to that limit.
+ *
+ * With more than one thread the boards are read and solved in chunks, so
+ * results are written once the chunk they belong to has been solved.
+ *
+ * With an archive name, the valid boards are also stored with their results
+ * and stats in that BoardArchive file.
+ */
+int solve_batch(std::istream& in, std::ostream& out, int thread_count, Settings::Sudoku::Engine engine,
+                const Settings::SolverOptions& solver_options, int solution_limit, const std::string& archive_name) {
+    BoardReader reader(in);
+    // Created for the layout of the first board
+    std::unique_ptr<SudokuBatchSolver> batch_solver;
+    std::ofstream archive_file;
+    std::unique_ptr<BoardArchiveWriter> archive;
+    size_t chunk_size = 1;
+    int solved = 0;
+    int failed = 0;
+    SudokuBoard board;
+    std::vector<SudokuBoard> boards;
+    std::vector<int> board_indices;
+    auto solve_chunk = [&]() {
+        if (boards.empty()) {
+            return;
+        }
+        auto results = batch_solver->solve(boards);
+        for (size_t i = 0; i < results.size(); ++i) {
+            write_result(out, board_indices[i], results[i], solution_limit);
+            if (archive) {
+                archive->write(boards[i], results[i]);
+            }
+            if (results[i].solved) {
+                ++solved;
+            } else {
+                ++failed;
+            }
+        }
+        boards.clear();
+        board_indices.clear();
+    };
+    auto batch_start = std::chrono::high_resolution_clock::now();
+    BoardReader::Status status;
+    while ((status = reader.read(board)) != BoardReader::Status::END) {
+        if (status == BoardReader::Status::INVALID) {
+            out << "{\"index\":" << reader.get_line_index() << ",\"status\":\"invalid\",\"error\":\"" << json_escape(reader.get_error_message()) << "\"}\n";
+            ++failed;
+            continue;
+        }
+        if (!batch_solver) {
+            Settings::Sudoku::Type type;
+            Settings::Sudoku::get_standard_type(reader.get_side(), type);
+            batch_solver = std::make_unique<SudokuBatchSolver>(CompiledLayout::get(type), thread_count, engine, solver_options);
+            batch_solver->set_solution_limit(solution_limit);
+            chunk_size = batch_solver->get_thread_count() == 1 ? 1 : 1024;
+            if (!archive_name.empty()) {
+                archive_file.open(archive_name, std::ios::binary);
+                if (!archive_file) {
+                    std::clog << "Cannot open archive " << archive_name << '\n';
+                    return 1;
+                }
+                archive = std::make_unique<BoardArchiveWriter>(archive_file, *CompiledLayout::get(type), true, true);
+            }
+        }
+        boards.push_back(board);
+        board_indices.push_back(reader.get_line_index());
+        if (boards.size() == chunk_size) {
+            solve_chunk();
+        }
+    }
+    solve_chunk();
+    if (archive && !archive->finish()) {
+        std::clog << "Cannot write archive " << archive_name << '\n';
+        ++failed;
+    }
+    std::chrono::duration<double, std::milli> batch_time = std::chrono::high_resolution_clock::now() - batch_start;
+    std::clog << "Solved " << solved << " of " << (solved + failed) << " boards in " << batch_time.count() << " ms"
+              << " using " << (batch_solver ? batch_solver->get_thread_count() : 0) << " thread(s)\n";
+    return failed == 0 ? 0 : 2;
+}
+
+int solve_single(std::istream& in, Settings::Sudoku::Engine engine, const Settings::SolverOptions& solver_options) {
+    auto board = read_board(in);
+    auto t1 = std::chrono::high_resolution_clock::now();
+    SudokuPuzzle puzzle(Settings::PuzzleType::SUDOKU_9X9);
+    puzzle.set_engine(engine);
+    puzzle.set_solver_options(solver_options);
+    if (!puzzle.apply_board(board)) {
+        std::clog << "There is a contradiction in the parsed!\n";
+        return 2;
+    }
+    if (puzzle.solve()) {
+        std::chrono::duration<double, std::milli> time_taken = std::chrono::high_resolution_clock::now() - t1;
+        std::clog << "Solution found in " << time_taken.count() << " ms\n";
+        std::clog << "Stats: ";
+        write_stats(std::clog, puzzle.get_stats());
+        std::clog << '\n';
+
+        auto solution = puzzle.get_solution();
+        for (Position row = 0; row < solution.get_rows(); ++row) {
+            for (Position column = 0; column < solution.get_columns(); ++column) {
+                std::cout << static_cast<Value>(solution[row][column]) << ' ';
+            }
+            std::cout << '\n';
+        }
+    } else {
+        std::clog << "Solving the provided parsed is not possible\n";
+    }
+    return 0;
+}
+
+/**
+ * Solves the slitherlink puzzle of every file, writing one JSON object per
+ * file to out:
+ *
+ *  {"file":"loop.xpuz","status":"solved","time_ms":1.23,"stats":{...},"solution":["+-+-+","|3 2|",...]}
+ *
+ * status is one of solved, unsolvable or invalid, with solutions as in
+ * solve_batch when the solution limit is above one.
+ */
+int solve_slitherlinks(const std::vector<std::string>& file_names, std::ostream& out,
+                       const Settings::SolverOptions& solver_options, int solution_limit) {
+    int failed = 0;
+    for (const auto& file_name : file_names) {
+        out << "{\"file\":\"" << json_escape(file_name) << "\"";
+        QFile file(QString::fromStdString(file_name));
+        std::unique_ptr<GcPuzzle> puzzle;
+        if (file.open(QFile::ReadOnly | QFile::Text)) {
+            puzzle = PuzzleLoader::load_slitherlink_from_file(file);
+        }
+        if (!puzzle) {
+            out << ",\"status\":\"invalid\"}\n";
+            ++failed;
+            continue;
+        }
         auto t1 = std::chrono::high_resolution_clock::now();
-        SudokuPuzzle puzzle(Settings::PuzzleType::SUDOKU_9X9);
-        if (!puzzle.apply_board(board)) {
-            std::clog << "There is a contradiction in the parsed!\n";
+        puzzle->set_solver_options(solver_options);
+        puzzle->apply_board(puzzle->get_empty_board());
+        const int solutions = (solution_limit == 1) ? static_cast<int>(puzzle->solve()) : puzzle->count_solutions(solution_limit);
+        std::chrono::duration<double, std::milli> time_taken = std::chrono::high_resolution_clock::now() - t1;
+        out << ",\"status\":\"" << (solutions > 0 ? "solved" : "unsolvable") << "\",\"time_ms\":" << time_taken.count();
+        if (solution_limit > 1) {
+            out << ",\"solutions\":" << solutions;
+        }
+        out << ",\"stats\":";
+        write_stats(out, puzzle->get_stats());
+        if (solutions > 0) {
+            out << ",\"solution\":[";
+            auto lines = puzzle->draw(puzzle->get_solution());
+            for (size_t i = 0; i < lines.size(); ++i) {
+                out << (i == 0 ? "" : ",") << '"' << json_escape(lines[i]) << '"';
+            }
+            out << ']';
+        } else {
+            ++failed;
+        }
+        out << "}\n";
+    }
+    return failed == 0 ? 0 : 2;
+}
+
+/**
+ * Writes count generated puzzles with a unique solution to out, one board per
+ * line in the format of board_to_line. With a target of 0 clues every puzzle
+ * is minimal, otherwise clues are removed until the target is reached or no
+ * more can be removed.
+ */
+int generate(std::ostream& out, int count, Settings::Sudoku::Type type, unsigned int seed, int target_clues, int thread_count,
+             Settings::Sudoku::Engine engine, const Settings::SolverOptions& solver_options) {
+    SudokuGenerator generator(CompiledLayout::get(type), seed, thread_count, engine, solver_options);
+    for (int i = 0; i < count; ++i) {
+        auto t1 = std::chrono::high_resolution_clock::now();
+        auto puzzle = generator.generate(target_clues);
+        std::chrono::duration<double, std::milli> time_taken = std::chrono::high_resolution_clock::now() - t1;
+        out << board_to_line(puzzle) << '\n';
+        std::clog << "Generated puzzle " << i << " in " << time_taken.count() << " ms\n";
+    }
+    return 0;
+}
+
+/**
+ * Converts a file with one board per line, in the format of BoardReader, to
+ * a BoardArchive file. Invalid lines are reported and left out.
+ */
+int pack(const std::string& text_name, const std::string& archive_name) {
+    std::ifstream in(text_name, std::ios::binary);
+    if (!in) {
+        std::clog << "Cannot open input file " << text_name << '\n';
+        return 1;
+    }
+    std::ofstream out(archive_name, std::ios::binary);
+    if (!out) {
+        std::clog << "Cannot open archive " << archive_name << '\n';
+        return 1;
+    }
+    BoardReader reader(in);
+    std::unique_ptr<BoardArchiveWriter> archive;
+    SudokuBoard board;
+    int packed = 0;
+    int invalid = 0;
+    BoardReader::Status status;
+    while ((status = reader.read(board)) != BoardReader::Status::END) {
+        if (status == BoardReader::Status::INVALID) {
+            std::clog << text_name << ": line " << (reader.get_line_index() + 1) << " has " << reader.get_error_message() << '\n';
+            ++invalid;
+            continue;
+        }
+        if (!archive) {
+            Settings::Sudoku::Type type;
+            Settings::Sudoku::get_standard_type(reader.get_side(), type);
+            archive = std::make_unique<BoardArchiveWriter>(out, *CompiledLayout::get(type));
+        }
+        archive->write(board);
+        ++packed;
+    }
+    if (!archive) {
+        // An empty archive still needs a layout
+        archive = std::make_unique<BoardArchiveWriter>(out, *CompiledLayout::get(Settings::Sudoku::Type::S9X9));
+    }
+    if (!archive->finish()) {
+        std::clog << "Cannot write archive " << archive_name << '\n';
+        return 1;
+    }
+    std::clog << "Packed " << packed << " boards, skipped " << invalid << " invalid lines\n";
+    return invalid == 0 ? 0 : 2;
+}
+
+/**
+ * Writes the boards of a BoardArchive file to out, one per line in the
+ * format of board_to_line. When the archive holds results, every line is the
+ * JSON object of the batch mode instead, with an extra "board" member.
+ */
+int unpack(const std::string& archive_name, std::ostream& out) {
+    std::ifstream in(archive_name, std::ios::binary);
+    auto archive = BoardArchiveReader::open(in);
+    if (!archive) {
+        std::clog << "Cannot read archive " << archive_name << '\n';
+        return 1;
+    }
+    SudokuBoard board;
+    SudokuBatchResult result;
+    for (std::uint64_t index = 0; index < archive->size(); ++index) {
+        if (!archive->read(index, board, result)) {
+            std::clog << archive_name << ": board " << index << " cannot be read\n";
             return 2;
         }
-        if (puzzle.solve()) {
-            std::chrono::duration<double, std::milli> time_taken = std::chrono::high_resolution_clock::now() - t1;
-            std::clog << "Solution found in " << time_taken.count() << " ms\n";
+        if (archive->has_results()) {
+            write_result(out, static_cast<int>(index), result, 2, &board);
+        } else {
+            out << board_to_line(board) << '\n';
+        }
+    }
+    return 0;
+}
 
-            auto solution = puzzle.get_solution();
-            for (auto const& row : solution) {
-                for (auto const& col : row) {
-                    std::cout << col << ' ';
-                }
-                std::cout << '\n';
+void print_usage(const char* program) {
+    std::clog << "Usage: " << program << " [options]                   read a single board (9 lines) from stdin\n"
+              << "       " << program << " --batch [file] [--threads N] [--count-solutions N] [--archive A] [options]\n"
+              << "                           solve one 9x9, 16x16 or 25x25 board per line\n"
+              << "                           from file (or stdin),\n"
+              << "                           on N threads (0 uses all hardware threads),\n"
+              << "                           counting up to N solutions (2 checks uniqueness)\n"
+              << "                           and storing boards and results in archive A\n"
+              << "       " << program << " --generate N [--layout L] [--seed S] [--clues C] [--threads N] [options]\n"
+              << "                           generate N puzzles with a unique solution and at\n"
+              << "                           most C clues if possible (0, the default, gives\n"
+              << "                           minimal puzzles); layouts are 9x9 (default),\n"
+              << "                           16x16, 25x25, twin and mix\n"
+              << "       " << program << " --slitherlink file... [--count-solutions N] [options]\n"
+              << "                           solve the slitherlink puzzle (.xpuz) of every file\n"
+              << "       " << program << " --pack file archive\n"
+              << "                           store the boards of file, one per line, in a\n"
+              << "                           compact binary archive\n"
+              << "       " << program << " --unpack archive\n"
+              << "                           write the boards (and results) of an archive\n"
+              << "Options:\n"
+              << "  --engine E    minisat (default) or propagation\n"
+              << "  --amo A       at-most-one encoding of the minisat engine: auto (default),\n"
+              << "                pairwise, sequential, commander, product or bimander\n"
+              << "  --backend B   SAT solver of the minisat engine and slitherlinks: minisat\n"
+              << "                (default) or ipasir, if built with an IPASIR library\n"
+              << "  --preprocess P\n"
+              << "                simplify the encoding of minisat before the first solve:\n"
+              << "                none (default), light, normal or heavy\n"
+              << "  --portfolio K race K differently configured minisat solvers on their own\n"
+              << "                thread for every solve and take the first answer\n"
+              << "  --no-presolve encode the whole board for minisat instead of only what\n"
+              << "                single propagation leaves open\n";
+}
+
+bool parse_engine(const std::string& name, Settings::Sudoku::Engine& engine) {
+    if (name == "minisat") {
+        engine = Settings::Sudoku::Engine::MINISAT;
+    } else if (name == "propagation") {
+        engine = Settings::Sudoku::Engine::PROPAGATION;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+bool parse_layout(const std::string& name, Settings::Sudoku::Type& type) {
+    static const std::map<std::string, Settings::Sudoku::Type> layouts = { {"9x9", Settings::Sudoku::Type::S9X9},
+                                                                            {"16x16", Settings::Sudoku::Type::S16X16},
+                                                                            {"25x25", Settings::Sudoku::Type::S25X25},
+                                                                            {"twin", Settings::Sudoku::Type::T9X15},
+                                                                            {"mix", Settings::Sudoku::Type::M9X9_TWICE_COUPLED},
+                                                                          };
+    if (layouts.count(name) == 0) {
+        return false;
+    }
+    type = layouts.at(name);
+    return true;
+}
+
+bool parse_amo_encoding(const std::string& name, Settings::AmoEncoding& encoding) {
+    static const std::map<std::string, Settings::AmoEncoding> encodings = { {"pairwise", Settings::AmoEncoding::PAIRWISE},
+                                                                            {"sequential", Settings::AmoEncoding::SEQUENTIAL},
+                                                                            {"commander", Settings::AmoEncoding::COMMANDER},
+                                                                            {"product", Settings::AmoEncoding::PRODUCT},
+                                                                            {"bimander", Settings::AmoEncoding::BIMANDER},
+                                                                            {"auto", Settings::AmoEncoding::AUTO},
+                                                                          };
+    if (encodings.count(name) == 0) {
+        return false;
+    }
+    encoding = encodings.at(name);
+    return true;
+}
+
+bool parse_backend(const std::string& name, Settings::Backend& backend) {
+    if (name == "minisat") {
+        backend = Settings::Backend::MINISAT;
+    } else if (name == "ipasir") {
+        backend = Settings::Backend::IPASIR;
+    } else {
+        return false;
+    }
+    return is_sat_backend_available(backend);
+}
+
+bool parse_preprocessing(const std::string& name, Settings::Preprocessing& preprocessing) {
+    static const std::map<std::string, Settings::Preprocessing> levels = { {"none", Settings::Preprocessing::NONE},
+                                                                           {"light", Settings::Preprocessing::LIGHT},
+                                                                           {"normal", Settings::Preprocessing::NORMAL},
+                                                                           {"heavy", Settings::Preprocessing::HEAVY},
+                                                                         };
+    if (levels.count(name) == 0) {
+        return false;
+    }
+    preprocessing = levels.at(name);
+    return true;
+}
+
+} // end anonymous namespace
+
+
+
+int main(int argc, char* argv[]) {
+    try {
+        std::vector<std::string> args(argv + 1, argv + argc);
+        bool batch = false;
+        bool slitherlink = false;
+        std::vector<std::string> slitherlink_files;
+        int generate_count = 0;
+        Settings::Sudoku::Type layout = Settings::Sudoku::Type::S9X9;
+        unsigned int seed = std::random_device()();
+        int target_clues = 0;
+        std::string file_name = "-";
+        int thread_count = 1;
+        int solution_limit = 1;
+        Settings::Sudoku::Engine engine = Settings::Sudoku::Engine::MINISAT;
+        Settings::SolverOptions solver_options;
+        std::string archive_name;
+        if ((args.size() == 3) && (args[0] == "--pack")) {
+            return pack(args[1], args[2]);
+        }
+        if ((args.size() == 2) && (args[0] == "--unpack")) {
+            return unpack(args[1], std::cout);
+        }
+        for (size_t i = 0; i < args.size(); ++i) {
+            if ((args[i] == "--batch") && (i == 0)) {
+                batch = true;
+            } else if ((args[i] == "--slitherlink") && (i == 0)) {
+                slitherlink = true;
+            } else if (slitherlink && (args[i] == "--count-solutions") && (i + 1 < args.size())) {
+                solution_limit = std::stoi(args[++i]);
+            } else if (slitherlink && (args[i][0] != '-')) {
+                slitherlink_files.push_back(args[i]);
+            } else if ((args[i] == "--generate") && (i == 0) && (i + 1 < args.size())) {
+                generate_count = std::stoi(args[++i]);
+            } else if ((batch || generate_count) && (args[i] == "--threads") && (i + 1 < args.size())) {
+                thread_count = std::stoi(args[++i]);
+            } else if (generate_count && (args[i] == "--layout") && (i + 1 < args.size()) && parse_layout(args[i + 1], layout)) {
+                ++i;
+            } else if (generate_count && (args[i] == "--seed") && (i + 1 < args.size())) {
+                seed = static_cast<unsigned int>(std::stoul(args[++i]));
+            } else if (generate_count && (args[i] == "--clues") && (i + 1 < args.size())) {
+                target_clues = std::stoi(args[++i]);
+            } else if (batch && (args[i] == "--count-solutions") && (i + 1 < args.size())) {
+                solution_limit = std::stoi(args[++i]);
+            } else if (batch && (args[i] == "--archive") && (i + 1 < args.size())) {
+                archive_name = args[++i];
+            } else if ((args[i] == "--engine") && (i + 1 < args.size()) && parse_engine(args[i + 1], engine)) {
+                ++i;
+            } else if ((args[i] == "--amo") && (i + 1 < args.size()) && parse_amo_encoding(args[i + 1], solver_options.amo_encoding)) {
+                ++i;
+            } else if ((args[i] == "--backend") && (i + 1 < args.size()) && parse_backend(args[i + 1], solver_options.backend)) {
+                ++i;
+            } else if ((args[i] == "--preprocess") && (i + 1 < args.size()) && parse_preprocessing(args[i + 1], solver_options.preprocessing)) {
+                ++i;
+            } else if ((args[i] == "--portfolio") && (i + 1 < args.size())) {
+                solver_options.portfolio_size = std::stoi(args[++i]);
+            } else if (args[i] == "--no-presolve") {
+                solver_options.presolve = false;
+            } else if (batch && ((args[i][0] != '-') || (args[i] == "-"))) {
+                file_name = args[i];
+            } else {
+                print_usage(argv[0]);
+                return 1;
             }
-        } else {
-            std::clog << "Solving the provided parsed is not possible\n";
         }
+        if (slitherlink) {
+            return solve_slitherlinks(slitherlink_files, std::cout, solver_options, solution_limit);
+        }
+        if (generate_count) {
+            std::clog << "Using seed " << seed << '\n';
+            return generate(std::cout, generate_count, layout, seed, target_clues, thread_count, engine, solver_options);
+        }
+        if (!batch) {
+            return solve_single(std::cin, engine, solver_options);
+        }
+        if (file_name == "-") {
+            return solve_batch(std::cin, std::cout, thread_count, engine, solver_options, solution_limit, archive_name);
+        }
+        std::ifstream input(file_name, std::ios::binary);
+        if (!input) {
+            std::clog << "Cannot open input file " << file_name << '\n';
+            return 1;
+        }
+        return solve_batch(input, std::cout, thread_count, engine, solver_options, solution_limit, archive_name);
     } catch(std::exception const& ex) {
         std::clog << "Failed parsing because: " << ex.what() << std::endl;
         return 1;
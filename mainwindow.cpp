@@ -7,11 +7,23 @@
 #include <QMessageBox>
 #include <QMouseEvent>
 #include <QStandardItemModel>
+#include <QtConcurrent>
 
 #include <chrono>
 #include <iostream>
 #include <sstream>
 
+namespace {
+    QString format_stats(const SolverStats& stats)
+    {
+        std::ostringstream ss;
+        ss << stats.variables << " variables, " << stats.clauses << " clauses, "
+           << stats.conflicts << " conflicts, " << stats.decisions << " decisions, "
+           << stats.propagations << " propagations, " << stats.restarts << " restarts\n"
+           << "encode " << stats.encode_ms << " ms, apply " << stats.apply_ms << " ms, solve " << stats.solve_ms << " ms";
+        return QString::fromStdString(ss.str());
+    }
+}
 
 MainWindow::MainWindow(QWidget *parent) :
     QMainWindow(parent),
@@ -41,7 +53,7 @@ MainWindow::MainWindow(QWidget *parent) :
 
     auto fileMenu = menuBar()->addMenu(tr("&File"));
 
-    QAction *loadAction = new QAction(tr("&Load puzzle..."), this);
+    loadAction = new QAction(tr("&Load puzzle..."), this);
     loadAction->setShortcut(QKeySequence(Qt::CTRL + Qt::Key_L));
     loadAction->setStatusTip(tr("Load a puzzle format..."));
     connect(loadAction, &QAction::triggered, this, &MainWindow::load);
@@ -53,7 +65,7 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(saveAction, &QAction::triggered, this, &MainWindow::save);
     fileMenu->addAction(saveAction);
 
-    auto predefinedMenu = fileMenu->addMenu(tr("Predefined boards"));
+    predefinedMenu = fileMenu->addMenu(tr("Predefined boards"));
     int index = 1;
     for (auto predefined : PREDEFINED_PUZZLES)
     {
@@ -88,6 +100,17 @@ MainWindow::MainWindow(QWidget *parent) :
     connect(solveAction, &QAction::triggered, this, &MainWindow::solve);
     menuBar()->addAction(solveAction);
 
+    cancelAction = new QAction(tr("Ca&ncel solve"), this);
+    cancelAction->setShortcut(QKeySequence(Qt::Key_Escape));
+    cancelAction->setStatusTip(tr("Stop solving the puzzle"));
+    connect(cancelAction, &QAction::triggered, this, &MainWindow::cancel_solve);
+    menuBar()->addAction(cancelAction);
+
+    connect(&m_solve_watcher, &QFutureWatcher<bool>::finished, this, &MainWindow::solve_finished);
+    connect(this, &MainWindow::solve_progress, this, [this](quint64 conflicts, quint64 decisions) {
+        statusBar()->showMessage(tr("Solving... %1 conflicts, %2 decisions").arg(conflicts).arg(decisions));
+    });
+
     for (auto color : COLORNAME_TO_PUZZLECOLOR)
     {
         ui->colorCombo->addItem(color.first, static_cast<int>(color.second));
@@ -123,6 +146,12 @@ MainWindow::MainWindow(QWidget *parent) :
 
 MainWindow::~MainWindow()
 {
+    // The worker uses the puzzle, so it has to stop before the puzzle is destroyed
+    if (m_solving)
+    {
+        cancel_solve();
+        m_solve_watcher.waitForFinished();
+    }
     delete ui;
 }
 
@@ -157,7 +186,7 @@ void MainWindow::save()
     }
 
     SudokuBoard board = parse_sudoku_board();
-    auto board_settings = m_sudoku_puzzle->get_board_settings();
+    const auto& board_settings = m_sudoku_puzzle->get_board_settings();
     PuzzleSaver::save_to_file(board_settings, board, file);
 
     ui->output->append(tr("Puzzle was saved to file %1.\n").arg(QDir::toNativeSeparators(file_name)));
@@ -180,8 +209,15 @@ void MainWindow::load()
         return;
     }
 
+    m_gc_puzzle.reset();
     m_sudoku_puzzle = PuzzleLoader::load_from_file(file);
-    if (m_sudoku_puzzle)
+    if (!m_sudoku_puzzle)
+    {
+        file.seek(0);
+        m_gc_puzzle = PuzzleLoader::load_slitherlink_from_file(file);
+        m_gc_drawn = false;
+    }
+    if (m_sudoku_puzzle || m_gc_puzzle)
     {
         ui->output->append(tr("Puzzle was loaded from file %1.\n").arg(QDir::toNativeSeparators(file_name)));
     }
@@ -200,6 +236,7 @@ void MainWindow::load_predefined(const std::string& puzzle_name, Settings::Puzzl
     if (puzzle_type == Settings::PuzzleType::GC414WQ)
     {
         m_gc_puzzle = std::make_unique<GcPuzzle>();
+        m_gc_drawn = true;
         ui->output->append(QString::fromStdString("Loading predefined puzzle: " + puzzle_name + "\n"));
     }
     else // Sudoku puzzle types
@@ -222,10 +259,6 @@ void MainWindow::update_ui_for_new_puzzle()
     m_model.reset();
     ui->regions->setVisible(false);
     ui->tableWidget->setVisible(false);
-    exampleAction->setEnabled(false);
-    clearAction->setEnabled(false);
-    saveAction->setEnabled(false);
-    solveAction->setEnabled(false);
     region_buttons_set_visible(false);
     ui->graphicsView->setVisible(false);
     if (m_sudoku_puzzle)
@@ -282,18 +315,37 @@ void MainWindow::update_ui_for_new_puzzle()
 
         ui->regions->setVisible(true);
         ui->tableWidget->setVisible(true);
-        exampleAction->setEnabled(m_sudoku_puzzle->has_example());
-        clearAction->setEnabled(true);
-        saveAction->setEnabled(true);
-        solveAction->setEnabled(true);
         region_buttons_set_visible(false);
     }
     else if (m_gc_puzzle)
     {
-        ui->graphicsView->setVisible(true);
-        clearAction->setEnabled(true);
-        solveAction->setEnabled(true);
+        ui->graphicsView->setVisible(m_gc_drawn);
+        if (!m_gc_drawn)
+        {
+            for (const auto& line : m_gc_puzzle->draw(m_gc_puzzle->get_empty_board()))
+            {
+                ui->output->append(QString::fromStdString(line));
+            }
+        }
     }
+    update_actions();
+}
+
+void MainWindow::update_actions()
+{
+    const bool has_puzzle = m_sudoku_puzzle || m_gc_puzzle;
+    loadAction->setEnabled(!m_solving);
+    predefinedMenu->setEnabled(!m_solving);
+    exampleAction->setEnabled(!m_solving && m_sudoku_puzzle && m_sudoku_puzzle->has_example());
+    clearAction->setEnabled(!m_solving && has_puzzle);
+    saveAction->setEnabled(!m_solving && m_sudoku_puzzle);
+    solveAction->setEnabled(!m_solving && has_puzzle);
+    cancelAction->setEnabled(m_solving);
+    ui->tableWidget->setEnabled(!m_solving);
+    ui->regions->setEnabled(!m_solving);
+    ui->okButton->setEnabled(!m_solving);
+    ui->deleteButton->setEnabled(!m_solving);
+    ui->graphicsView->setEnabled(!m_solving);
 }
 
 void MainWindow::color_board()
@@ -315,7 +367,7 @@ SudokuBoard MainWindow::parse_sudoku_board()
 {
     const Position rows = m_sudoku_puzzle->get_rows();
     const Position columns = m_sudoku_puzzle->get_columns();
-    SudokuBoard parsed(rows, std::vector<int>(columns));
+    SudokuBoard parsed(rows, columns);
     QFont font("Helvetica", 14, QFont::Bold);
     for (Position row = 0; row < rows; ++row)
     {
@@ -335,7 +387,7 @@ SudokuBoard MainWindow::parse_sudoku_board()
     return parsed;
 }
 
-void MainWindow::set_sudoku_board(SudokuBoard board_to_set)
+void MainWindow::set_sudoku_board(const SudokuBoard& board_to_set)
 {
     QFont font("Helvetica", 12);
     for (Position row = 0; row < m_sudoku_puzzle->get_rows(); ++row)
@@ -405,43 +457,98 @@ void MainWindow::set_gc_board(GcBoard board_to_set)
 
 void MainWindow::solve()
 {
+    if (m_solving)
+        return;
+    // Reported on a solving or watchdog thread, the signal is queued to this
+    // thread
+    auto report_progress = [this](const SolverStats& stats) {
+        emit solve_progress(stats.conflicts, stats.decisions);
+    };
+    m_solve_start = std::chrono::high_resolution_clock::now();
     if (m_sudoku_puzzle)
     {
         auto board = parse_sudoku_board();
-        auto t1 = std::chrono::high_resolution_clock::now();
-        if (!m_sudoku_puzzle->apply_board(board)) {
+        // The session keeps the solver between solves, only the givens change
+        SudokuSession& session = m_sudoku_puzzle->get_session();
+        session.set_givens(board);
+        if (!session.is_consistent()) {
             ui->output->append("There is a contradiction in the parsed board!");
         }
-        if (m_sudoku_puzzle->solve()) {
-            std::chrono::duration<double, std::milli> time_taken = std::chrono::high_resolution_clock::now() - t1;
-            std::ostringstream ss;
-            ss << "Solution found in " << time_taken.count() << " ms";
-            ui->output->append(QString::fromStdString(ss.str()));
-            set_sudoku_board(m_sudoku_puzzle->get_solution());
-        } else {
-            std::ostringstream ss;
-            ss << "Solving the provided parsed board is not possible!";
-            ui->output->append(QString::fromStdString(ss.str()));
-        }
+        session.set_progress_callback(report_progress);
+        // A cancel that came after the last solve finished would stop this one
+        session.clear_interrupt();
+        m_solve_watcher.setFuture(QtConcurrent::run([&session] { return session.solve(); }));
     }
     else if (m_gc_puzzle)
     {
-        auto board = parse_gc_board();
-        auto t1 = std::chrono::high_resolution_clock::now();
+        auto board = m_gc_drawn ? parse_gc_board() : m_gc_puzzle->get_empty_board();
+        m_gc_puzzle->set_progress_callback(report_progress);
         if (!m_gc_puzzle->apply_board(board)) {
             ui->output->append("There is a contradiction in the parsed board!");
         }
-        if (m_gc_puzzle->solve()) {
-            std::chrono::duration<double, std::milli> time_taken = std::chrono::high_resolution_clock::now() - t1;
-            std::ostringstream ss;
-            ss << "Solution found in " << time_taken.count() << " ms";
-            ui->output->append(QString::fromStdString(ss.str()));
+        m_gc_puzzle->clear_interrupt();
+        GcPuzzle* gc_puzzle = m_gc_puzzle.get();
+        m_solve_watcher.setFuture(QtConcurrent::run([gc_puzzle] { return gc_puzzle->solve(); }));
+    }
+    else
+    {
+        return;
+    }
+    m_solving = true;
+    m_solve_cancelled = false;
+    statusBar()->showMessage(tr("Solving..."));
+    update_actions();
+}
+
+void MainWindow::cancel_solve()
+{
+    if (!m_solving)
+        return;
+    m_solve_cancelled = true;
+    if (m_sudoku_puzzle)
+    {
+        m_sudoku_puzzle->get_session().interrupt();
+    }
+    else if (m_gc_puzzle)
+    {
+        m_gc_puzzle->interrupt();
+    }
+}
+
+void MainWindow::solve_finished()
+{
+    m_solving = false;
+    statusBar()->clearMessage();
+    update_actions();
+    const bool solved = m_solve_watcher.result();
+    std::chrono::duration<double, std::milli> time_taken = std::chrono::high_resolution_clock::now() - m_solve_start;
+    std::ostringstream ss;
+    if (solved) {
+        ss << "Solution found in " << time_taken.count() << " ms";
+    } else if (m_solve_cancelled) {
+        ss << "Solving was cancelled after " << time_taken.count() << " ms";
+    } else {
+        ss << "Solving the provided parsed board is not possible!";
+    }
+    ui->output->append(QString::fromStdString(ss.str()));
+    if (m_sudoku_puzzle)
+    {
+        SudokuSession& session = m_sudoku_puzzle->get_session();
+        if (solved) {
+            set_sudoku_board(session.get_solution());
+        }
+        ui->output->append(format_stats(session.get_stats()));
+    }
+    else if (m_gc_puzzle)
+    {
+        if (solved && m_gc_drawn) {
             set_gc_board(m_gc_puzzle->get_solution());
-        } else {
-            std::ostringstream ss;
-            ss << "Solving the provided parsed board is not possible!";
-            ui->output->append(QString::fromStdString(ss.str()));
+        } else if (solved) {
+            for (const auto& line : m_gc_puzzle->draw(m_gc_puzzle->get_solution())) {
+                ui->output->append(QString::fromStdString(line));
+            }
         }
+        ui->output->append(format_stats(m_gc_puzzle->get_stats()));
     }
 }
 
@@ -4,9 +4,11 @@
 #include "sudokupuzzle.hpp"
 #include "gcpuzzle.hpp"
 #include <QAbstractItemModel>
+#include <QFutureWatcher>
 #include <QGraphicsLineItem>
 #include <QMainWindow>
 #include <QPen>
+#include <chrono>
 #include <map>
 #include <memory>
 #include <vector>
@@ -23,6 +25,10 @@ public:
     explicit MainWindow(QWidget *parent = 0);
     ~MainWindow();
 
+signals:
+    // Emitted from the solving thread now and then during a solve
+    void solve_progress(quint64 conflicts, quint64 decisions);
+
 private slots:
     void on_regions_clicked(const QModelIndex &index);
 
@@ -34,6 +40,8 @@ private slots:
 
     void on_deleteButton_clicked();
 
+    void solve_finished();
+
 private:
     enum class PointerAtLineSegment
     {
@@ -50,23 +58,28 @@ private:
     void load();    
     void load_predefined(const std::string& puzzle_name, Settings::PuzzleType puzzle_type);
     void update_ui_for_new_puzzle();
+    void update_actions();
     void color_board();
     SudokuBoard parse_sudoku_board();
-    void set_sudoku_board(SudokuBoard board_to_set);
+    void set_sudoku_board(const SudokuBoard& board_to_set);
     GcBoard parse_gc_board();
     void set_gc_board(GcBoard board_to_set);
 
     void clear();
     void set_example();
     void solve();
+    void cancel_solve();
 
     void region_buttons_set_visible(bool visible);
 
     Ui::MainWindow *ui;
+    QAction* loadAction;
+    QMenu* predefinedMenu;
     QAction* clearAction;
     QAction* exampleAction;
     QAction* saveAction;
     QAction* solveAction;
+    QAction* cancelAction;
 
     const std::vector<std::pair<std::string, Settings::PuzzleType>> PREDEFINED_PUZZLES;
     const std::map<Settings::PuzzleColor, QColor> PUZZLECOLOR_TO_DISPLAYCOLOR;
@@ -85,8 +98,18 @@ private:
 
     std::unique_ptr<SudokuPuzzle> m_sudoku_puzzle;
     std::unique_ptr<GcPuzzle> m_gc_puzzle;
+    // Only GC414WQ is drawn on its picture, a slitherlink loaded from a file
+    // is solved from an empty board and its loop is written to the output
+    bool m_gc_drawn = false;
     std::unique_ptr<QAbstractItemModel> m_model;
 
+    // The puzzle is solved on a worker thread, while solving nothing may
+    // change the puzzle
+    QFutureWatcher<bool> m_solve_watcher;
+    bool m_solving = false;
+    bool m_solve_cancelled = false;
+    std::chrono::high_resolution_clock::time_point m_solve_start;
+
     const int ADD_NEW_REGION = -1;
     int m_current_region;
 };
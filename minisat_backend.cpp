@@ -0,0 +1,99 @@
+#include "minisat_backend.hpp"
+
+MinisatBackend::MinisatBackend(Settings::SolverOptions const& solver_options) {
+    m_solver.random_seed = solver_options.random_seed;
+    m_solver.random_var_freq = solver_options.random_var_freq;
+    m_solver.rnd_init_act = solver_options.random_initial_activity;
+    m_solver.phase_saving = solver_options.phase_saving;
+    m_solver.luby_restart = solver_options.luby_restart;
+    switch (solver_options.preprocessing) {
+    case Settings::Preprocessing::NONE:
+        // Frees the occurrence lists, so that SimpSolver runs like Solver
+        m_solver.eliminate(true);
+        m_preprocessed = true;
+        break;
+    case Settings::Preprocessing::LIGHT:
+        m_solver.clause_lim = 10;
+        m_solver.subsumption_lim = 100;
+        break;
+    case Settings::Preprocessing::NORMAL:
+        break;
+    case Settings::Preprocessing::HEAVY:
+        m_solver.grow = 8;
+        m_solver.clause_lim = -1;
+        m_solver.subsumption_lim = -1;
+        m_solver.use_asymm = true;
+        break;
+    }
+}
+
+Minisat::Var MinisatBackend::new_var() {
+    return m_solver.newVar();
+}
+
+bool MinisatBackend::add_clause(Minisat::vec<Minisat::Lit> const& literals) {
+    return m_solver.addClause(literals);
+}
+
+void MinisatBackend::freeze(Minisat::Var var) {
+    m_solver.setFrozen(var, true);
+}
+
+void MinisatBackend::preprocess(Minisat::vec<Minisat::Lit> const& assumptions) {
+    ScopedTimer timer(m_preprocess_ms);
+    for (int i = 0; i < assumptions.size(); ++i) {
+        m_solver.setFrozen(var(assumptions[i]), true);
+    }
+    const int clauses = m_solver.nClauses();
+    // Eliminates once and then turns the simplifier off, so that clauses
+    // added later do not have to be checked against eliminated variables
+    m_solver.eliminate(true);
+    m_removed_clauses = clauses - m_solver.nClauses();
+    m_preprocessed = true;
+}
+
+Minisat::lbool MinisatBackend::solve_limited(Minisat::vec<Minisat::Lit> const& assumptions) {
+    if (!m_preprocessed) {
+        preprocess(assumptions);
+    }
+    const Minisat::lbool result = m_solver.solveLimited(assumptions);
+    if (result.isTrue()) {
+        m_solver.model.copyTo(model);
+    }
+    return result;
+}
+
+void MinisatBackend::set_budget(std::int64_t conflicts, std::int64_t propagations) {
+    m_solver.budgetOff();
+    if (conflicts >= 0) {
+        m_solver.setConfBudget(conflicts);
+    }
+    if (propagations >= 0) {
+        m_solver.setPropBudget(propagations);
+    }
+}
+
+void MinisatBackend::set_terminate(std::function<bool()>) {
+}
+
+void MinisatBackend::interrupt() {
+    m_solver.interrupt();
+}
+
+void MinisatBackend::clear_interrupt() {
+    m_solver.clearInterrupt();
+}
+
+SolverStats MinisatBackend::get_stats() const {
+    SolverStats stats;
+    stats.variables = m_solver.nVars();
+    stats.clauses = m_solver.nClauses();
+    stats.conflicts = m_solver.conflicts;
+    stats.decisions = m_solver.decisions;
+    stats.propagations = m_solver.propagations;
+    stats.restarts = m_solver.starts;
+    stats.eliminated_variables = m_solver.eliminated_vars;
+    stats.removed_clauses = m_removed_clauses;
+    stats.preprocess_ms = m_preprocess_ms;
+    return stats;
+}
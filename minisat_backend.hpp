@@ -0,0 +1,33 @@
+#pragma once
+
+#include "sat_backend.hpp"
+#include <minisat/simp/SimpSolver.h>
+
+// MiniSat 2.2, which supports every feature of the interface. It runs on
+// SimpSolver, whose simplifier is turned off right away without
+// preprocessing.
+class MinisatBackend : public SatBackend {
+public:
+    explicit MinisatBackend(Settings::SolverOptions const& solver_options);
+
+    Minisat::Var new_var() override;
+    bool add_clause(Minisat::vec<Minisat::Lit> const& literals) override;
+    using SatBackend::add_clause;
+    void freeze(Minisat::Var var) override;
+    // Preprocesses once, before the first solve
+    Minisat::lbool solve_limited(Minisat::vec<Minisat::Lit> const& assumptions) override;
+    void set_budget(std::int64_t conflicts, std::int64_t propagations) override;
+    // MiniSat is stopped through its budgets and interrupt instead
+    void set_terminate(std::function<bool()> terminate) override;
+    void interrupt() override;
+    void clear_interrupt() override;
+    SolverStats get_stats() const override;
+
+private:
+    void preprocess(Minisat::vec<Minisat::Lit> const& assumptions);
+
+    Minisat::SimpSolver m_solver;
+    bool m_preprocessed = false;
+    int m_removed_clauses = 0;
+    double m_preprocess_ms = 0.0;
+};
@@ -0,0 +1,40 @@
+#include "portfolio.hpp"
+
+#include <algorithm>
+
+namespace {
+    // Only used when the options leave the encoding to the solver
+    const std::vector<Settings::AmoEncoding> PORTFOLIO_ENCODINGS {
+        Settings::AmoEncoding::AUTO,
+        Settings::AmoEncoding::SEQUENTIAL,
+        Settings::AmoEncoding::COMMANDER,
+        Settings::AmoEncoding::PRODUCT,
+        Settings::AmoEncoding::BIMANDER,
+        Settings::AmoEncoding::PAIRWISE,
+    };
+}
+
+std::vector<Settings::SolverOptions> portfolio_options(const Settings::SolverOptions& options)
+{
+    std::vector<Settings::SolverOptions> portfolio;
+    const int size = std::max(1, options.portfolio_size);
+    for (int i = 0; i < size; ++i)
+    {
+        Settings::SolverOptions member = options;
+        member.portfolio_size = 1;
+        if (i > 0)
+        {
+            member.random_seed = options.random_seed + i;
+            member.random_initial_activity = true;
+            member.random_var_freq = std::max(options.random_var_freq, 0.01);
+            member.phase_saving = (options.phase_saving + i) % 3;
+            member.luby_restart = ((i % 2) == 0) ? options.luby_restart : !options.luby_restart;
+            if (options.amo_encoding == Settings::AmoEncoding::AUTO)
+            {
+                member.amo_encoding = PORTFOLIO_ENCODINGS[i % PORTFOLIO_ENCODINGS.size()];
+            }
+        }
+        portfolio.push_back(member);
+    }
+    return portfolio;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include "solver_options.hpp"
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Returns options.portfolio_size (at least one) variations of the options.
+// The first one is options itself, the others differ in random seed, phase
+// saving, restart strategy and, with the AUTO encoding, the encoding.
+std::vector<Settings::SolverOptions> portfolio_options(const Settings::SolverOptions& options);
+
+// Races differently configured solvers of the same puzzle, every solver on
+// its own thread. The first solver with an answer wins and the others are
+// interrupted. Solver needs solve_limited, count_solutions, interrupt and
+// clear_interrupt, like SudokuEngine and GcSolver.
+template<class Solver>
+class Portfolio
+{
+public:
+    void add(std::unique_ptr<Solver> solver)
+    {
+        m_solvers.push_back(std::move(solver));
+        m_winner = 0;
+    }
+
+    const std::vector<std::unique_ptr<Solver>>& get_solvers() const
+    {
+        return m_solvers;
+    }
+
+    // The solver that answered the last solve, or the first one
+    Solver& get_winner() const
+    {
+        return *m_solvers[m_winner];
+    }
+
+    // Returns UNKNOWN if every solver ran into the limits or was interrupted
+    SolveResult solve_limited(const Settings::SolveLimits& limits)
+    {
+        m_winner = 0;
+        if (m_solvers.size() == 1)
+        {
+            return m_solvers.front()->solve_limited(limits);
+        }
+        return race(limits);
+    }
+
+    // Counts with the first solver only, racing does not help to count
+    int count_solutions(int limit)
+    {
+        m_winner = 0;
+        return m_solvers.front()->count_solutions(limit);
+    }
+
+    // A solver holds an interrupt until its next solve starts, so solvers
+    // whose thread has not reached its solve yet still stop
+    void interrupt()
+    {
+        for (auto& solver : m_solvers)
+        {
+            solver->interrupt();
+        }
+    }
+
+    void clear_interrupt()
+    {
+        for (auto& solver : m_solvers)
+        {
+            solver->clear_interrupt();
+        }
+    }
+
+private:
+    SolveResult race(const Settings::SolveLimits& limits)
+    {
+        std::mutex mutex;
+        std::condition_variable solver_finished;
+        std::vector<bool> finished(m_solvers.size(), false);
+        std::size_t finished_count = 0;
+        int winner = -1;
+        SolveResult result = SolveResult::UNKNOWN;
+
+        std::vector<std::thread> threads;
+        for (std::size_t i = 0; i < m_solvers.size(); ++i)
+        {
+            threads.emplace_back([&, i] {
+                const SolveResult solver_result = m_solvers[i]->solve_limited(limits);
+                std::lock_guard<std::mutex> lock(mutex);
+                finished[i] = true;
+                ++finished_count;
+                if ((winner < 0) && (solver_result != SolveResult::UNKNOWN))
+                {
+                    winner = static_cast<int>(i);
+                    result = solver_result;
+                }
+                solver_finished.notify_one();
+            });
+        }
+        {
+            // Sleeps until the first answer or until every solver gave up,
+            // the losers are interrupted once and then waited for
+            std::unique_lock<std::mutex> lock(mutex);
+            solver_finished.wait(lock, [&] { return (winner >= 0) || (finished_count == m_solvers.size()); });
+            for (std::size_t i = 0; i < m_solvers.size(); ++i)
+            {
+                if (!finished[i])
+                {
+                    m_solvers[i]->interrupt();
+                }
+            }
+            solver_finished.wait(lock, [&] { return finished_count == m_solvers.size(); });
+        }
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+        // A loser may have finished its solve before its interrupt arrived
+        clear_interrupt();
+        m_winner = (winner >= 0) ? winner : 0;
+        return result;
+    }
+
+    std::vector<std::unique_ptr<Solver>> m_solvers;
+    std::size_t m_winner = 0;
+};
@@ -0,0 +1,55 @@
+#include "portfoliosolver.hpp"
+
+PortfolioSolver::PortfolioSolver(const std::shared_ptr<const CompiledLayout>& layout, Settings::SolverOptions solver_options) {
+    for (const auto& options : portfolio_options(solver_options)) {
+        m_portfolio.add(std::make_unique<SudokuSolver>(layout, options));
+    }
+}
+
+bool PortfolioSolver::apply_board(SudokuBoardView b) {
+    bool consistent = true;
+    for (auto& engine : m_portfolio.get_solvers()) {
+        consistent = engine->apply_board(b) && consistent;
+    }
+    return consistent;
+}
+
+bool PortfolioSolver::assume_board(SudokuBoardView b) {
+    bool consistent = true;
+    for (auto& engine : m_portfolio.get_solvers()) {
+        consistent = engine->assume_board(b) && consistent;
+    }
+    return consistent;
+}
+
+bool PortfolioSolver::solve() {
+    return solve_limited(Settings::SolveLimits()) == SolveResult::SAT;
+}
+
+SolveResult PortfolioSolver::solve_limited(Settings::SolveLimits const& limits) {
+    return m_portfolio.solve_limited(limits);
+}
+
+int PortfolioSolver::count_solutions(int limit) {
+    return m_portfolio.count_solutions(limit);
+}
+
+SudokuBoard PortfolioSolver::get_solution() const {
+    return m_portfolio.get_winner().get_solution();
+}
+
+SolverStats PortfolioSolver::get_stats() const {
+    return m_portfolio.get_winner().get_stats();
+}
+
+void PortfolioSolver::set_progress_callback(ProgressCallback callback) {
+    m_portfolio.get_solvers().front()->set_progress_callback(callback);
+}
+
+void PortfolioSolver::interrupt() {
+    m_portfolio.interrupt();
+}
+
+void PortfolioSolver::clear_interrupt() {
+    m_portfolio.clear_interrupt();
+}
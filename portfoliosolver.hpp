@@ -0,0 +1,28 @@
+#pragma once
+
+#include "portfolio.hpp"
+#include "puzzle_types.hpp"
+#include "sudokuengine.hpp"
+#include "sudokusolver.hpp"
+
+// Races solver_options.portfolio_size differently configured MiniSat
+// engines, see portfolio_options, and takes the first answer. Counting
+// solutions only uses the first engine.
+class PortfolioSolver : public SudokuEngine {
+public:
+    PortfolioSolver(const std::shared_ptr<const CompiledLayout>& layout, Settings::SolverOptions solver_options);
+    bool apply_board(SudokuBoardView) override;
+    bool assume_board(SudokuBoardView) override;
+    bool solve() override;
+    SolveResult solve_limited(Settings::SolveLimits const& limits) override;
+    int count_solutions(int limit) override;
+    SudokuBoard get_solution() const override;
+    SolverStats get_stats() const override;
+    // Only the first engine reports its progress
+    void set_progress_callback(ProgressCallback callback) override;
+    void interrupt() override;
+    void clear_interrupt() override;
+
+private:
+    Portfolio<SudokuEngine> m_portfolio;
+};
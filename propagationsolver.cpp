@@ -0,0 +1,207 @@
+#include "propagationsolver.hpp"
+#include "compiledlayout.hpp"
+#include "fixed_propagation.hpp"
+
+#include <algorithm>
+
+namespace {
+    // Progress is reported and the deadline checked every this many branches
+    const std::uint64_t DECISIONS_PER_CHECK = 1024;
+}
+
+template <class Propagation>
+BasicPropagationSolver<Propagation>::BasicPropagationSolver(std::shared_ptr<const CompiledLayout> layout)
+    : m_layout(std::move(layout))
+    , m_board_settings(m_layout->get_board_settings())
+    , m_propagation(*m_layout)
+{
+}
+
+template <class Propagation>
+bool BasicPropagationSolver<Propagation>::is_valid(SudokuBoardView b) const {
+    if ((b.get_rows() != m_board_settings.rows) || (b.get_columns() != m_board_settings.columns)) {
+        return false;
+    }
+    for (Value value : b) {
+        if (value < m_board_settings.min_value || value > m_board_settings.max_value) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template <class Propagation>
+int BasicPropagationSolver<Propagation>::search(State& state, int limit) {
+    m_stopped = m_stopped || m_interrupter.interrupted() || budget_exhausted();
+    if (m_stopped) {
+        return 0;
+    }
+    const int open_cells = state.open_cells;
+    const bool consistent = m_propagation.propagate(state);
+    m_stats.propagations += open_cells - state.open_cells;
+    if (!consistent) {
+        ++m_stats.conflicts;
+        return 0;
+    }
+    if (state.open_cells == 0) {
+        if (!m_solved) {
+            m_solution = state;
+            m_solved = true;
+        }
+        return 1;
+    }
+    // Branch on the open cell with the minimum remaining values
+    const int branch_cell = m_propagation.fewest_candidates_cell(state);
+    int count = 0;
+    Candidates candidates = state.candidates[branch_cell];
+    while ((candidates != 0) && (count < limit) && !m_stopped) {
+        const Value value = Propagation::lowest(candidates);
+        candidates &= candidates - 1;
+        State next = state;
+        ++m_stats.decisions;
+        if ((m_stats.decisions % DECISIONS_PER_CHECK) == 0) {
+            if (m_progress_callback) {
+                report_progress();
+            }
+            m_stopped = m_stopped || deadline_passed();
+        }
+        if (m_propagation.place(next, branch_cell, value)) {
+            count += search(next, limit - count);
+        } else {
+            ++m_stats.conflicts;
+        }
+    }
+    return count;
+}
+
+template <class Propagation>
+bool BasicPropagationSolver<Propagation>::apply_board(SudokuBoardView b) {
+    assert(is_valid(b) && "Provided board is not valid!");
+    ScopedTimer timer(m_stats.apply_ms);
+    m_board = SudokuBoard(b);
+    m_solved = false;
+    m_initial = m_propagation.initial_state();
+    m_consistent = m_propagation.apply_givens(m_initial, b);
+    return m_consistent;
+}
+
+template <class Propagation>
+bool BasicPropagationSolver<Propagation>::assume_board(SudokuBoardView b) {
+    // The peers are part of the shared layout, so both are the same
+    return apply_board(b);
+}
+
+template <class Propagation>
+bool BasicPropagationSolver<Propagation>::solve() {
+    return count_solutions(1) == 1;
+}
+
+template <class Propagation>
+SolveResult BasicPropagationSolver<Propagation>::solve_limited(Settings::SolveLimits const& limits) {
+    m_limits = limits;
+    const int count = run_search(1);
+    m_limits = Settings::SolveLimits();
+    if (count == 1) {
+        return SolveResult::SAT;
+    }
+    return m_stopped ? SolveResult::UNKNOWN : SolveResult::UNSAT;
+}
+
+template <class Propagation>
+int BasicPropagationSolver<Propagation>::count_solutions(int limit) {
+    return run_search(limit);
+}
+
+template <class Propagation>
+int BasicPropagationSolver<Propagation>::run_search(int limit) {
+    SolveControl::Interrupter::Scope interrupt_scope(m_interrupter);
+    ScopedTimer timer(m_stats.solve_ms);
+    m_stats.conflicts = 0;
+    m_stats.decisions = 0;
+    m_stats.propagations = 0;
+    m_solved = false;
+    m_stopped = false;
+    m_solve_start = std::chrono::steady_clock::now();
+    int count = 0;
+    if (m_consistent && (limit > 0)) {
+        State state = m_initial;
+        count = search(state, limit);
+    }
+    return count;
+}
+
+template <class Propagation>
+bool BasicPropagationSolver<Propagation>::budget_exhausted() const {
+    return ((m_limits.conflict_budget > 0) && (m_stats.conflicts >= static_cast<std::uint64_t>(m_limits.conflict_budget)))
+        || ((m_limits.propagation_budget > 0) && (m_stats.propagations >= static_cast<std::uint64_t>(m_limits.propagation_budget)));
+}
+
+template <class Propagation>
+bool BasicPropagationSolver<Propagation>::deadline_passed() const {
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - m_solve_start;
+    return (m_limits.time_limit_ms > 0) && (elapsed.count() >= m_limits.time_limit_ms);
+}
+
+template <class Propagation>
+void BasicPropagationSolver<Propagation>::report_progress() const {
+    SolverStats stats = get_stats();
+    stats.solve_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_solve_start).count();
+    m_progress_callback(stats);
+}
+
+template <class Propagation>
+SudokuBoard BasicPropagationSolver<Propagation>::get_solution() const {
+    SudokuBoard b(m_board_settings.rows, m_board_settings.columns);
+    if (!m_solved) {
+        return b;
+    }
+    for (int row = 0; row < m_board_settings.rows; ++row) {
+        for (int col = 0; col < m_board_settings.columns; ++col) {
+            const int cell = m_layout->to_cell(row, col);
+            if (m_solution.values[cell] != 0) {
+                b[row][col] = m_solution.values[cell];
+            } else if (m_layout->is_used(cell)) {
+                // A cell outside every region can take any value
+                b[row][col] = (m_board[row][col] != 0) ? m_board[row][col] : 1;
+            }
+        }
+    }
+    return b;
+}
+
+template <class Propagation>
+SolverStats BasicPropagationSolver<Propagation>::get_stats() const {
+    SolverStats stats = m_stats;
+    stats.variables = m_layout->get_variables();
+    return stats;
+}
+
+template <class Propagation>
+void BasicPropagationSolver<Propagation>::set_progress_callback(ProgressCallback callback) {
+    m_progress_callback = callback;
+}
+
+template <class Propagation>
+void BasicPropagationSolver<Propagation>::interrupt() {
+    m_interrupter.interrupt();
+}
+
+template <class Propagation>
+void BasicPropagationSolver<Propagation>::clear_interrupt() {
+    m_interrupter.clear_interrupt();
+}
+
+template class BasicPropagationSolver<SinglePropagation>;
+template class BasicPropagationSolver<FixedPropagation<3>>;
+template class BasicPropagationSolver<FixedPropagation<4>>;
+
+std::unique_ptr<SudokuEngine> create_propagation_solver(std::shared_ptr<const CompiledLayout> layout) {
+    switch (layout->get_square_box()) {
+    case 3:
+        return std::make_unique<BasicPropagationSolver<FixedPropagation<3>>>(std::move(layout));
+    case 4:
+        return std::make_unique<BasicPropagationSolver<FixedPropagation<4>>>(std::move(layout));
+    default:
+        return std::make_unique<PropagationSolver>(std::move(layout));
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "puzzle_types.hpp"
+#include "single_propagation.hpp"
+#include "solve_control.hpp"
+#include "sudokuengine.hpp"
+#include "sudokusolver.hpp"
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Solves a sudoku without SAT solver: every cell keeps a bitmask of its
+// candidate values, naked and hidden singles are propagated to a fixed point
+// and the search branches on the open cell with the fewest candidates.
+// Propagation is a BasicSinglePropagation, SinglePropagation for any layout
+// or FixedPropagation for the square layouts it was compiled for, see
+// create_propagation_solver.
+template <class Propagation>
+class BasicPropagationSolver : public SudokuEngine {
+public:
+    BasicPropagationSolver(std::shared_ptr<const CompiledLayout> layout);
+    bool apply_board(SudokuBoardView) override;
+    bool assume_board(SudokuBoardView) override;
+    bool solve() override;
+    // The conflict and propagation budgets count the statistics below
+    SolveResult solve_limited(Settings::SolveLimits const& limits) override;
+    int count_solutions(int limit) override;
+    SudokuBoard get_solution() const override;
+    // Decisions are the branches taken, propagations the squares placed by
+    // propagation and conflicts the branches that ran into a contradiction.
+    // There are no clauses and restarts.
+    SolverStats get_stats() const override;
+    void set_progress_callback(ProgressCallback callback) override;
+    void interrupt() override;
+    void clear_interrupt() override;
+
+private:
+    using Candidates = typename Propagation::Candidates;
+    using State = typename Propagation::State;
+
+    bool is_valid(SudokuBoardView b) const;
+
+    // Returns the number of solutions below state, up to limit
+    int search(State& state, int limit);
+    // Searches from the applied board under m_limits
+    int run_search(int limit);
+    bool budget_exhausted() const;
+    bool deadline_passed() const;
+    void report_progress() const;
+
+    const std::shared_ptr<const CompiledLayout> m_layout;
+    const Settings::Sudoku::BoardSettings& m_board_settings;
+    const Propagation m_propagation;
+
+    SudokuBoard m_board;
+    bool m_consistent = false;
+    State m_initial;
+    State m_solution;
+    bool m_solved = false;
+    SolverStats m_stats;
+    ProgressCallback m_progress_callback;
+    std::chrono::steady_clock::time_point m_solve_start;
+    Settings::SolveLimits m_limits;
+    // Set when the last search stopped early for a limit or an interrupt
+    bool m_stopped = false;
+    SolveControl::Interrupter m_interrupter;
+};
+
+using PropagationSolver = BasicPropagationSolver<SinglePropagation>;
+
+// The solver specialized for the layout if it is a square layout, see
+// CompiledLayout::get_square_box, otherwise a PropagationSolver
+std::unique_ptr<SudokuEngine> create_propagation_solver(std::shared_ptr<const CompiledLayout> layout);
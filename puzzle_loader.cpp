@@ -213,6 +213,87 @@ namespace {
         }
         return success;
     }
+
+    bool parse_clues_from_element(QDomElement clues_element, int rows, int columns, GcClues& clues)
+    {
+        clues.clear();
+        for (QDomElement element = clues_element.firstChildElement(); !element.isNull(); element = element.nextSiblingElement())
+        {
+            if (element.tagName() != "row")
+            {
+                return false;
+            }
+            const std::string row = element.text().trimmed().toStdString();
+            if (static_cast<int>(row.size()) != columns)
+            {
+                return false;
+            }
+            std::vector<int> row_clues(columns, GC_NO_CLUE);
+            for (int column = 0; column < columns; ++column)
+            {
+                if ((row[column] >= '0') && (row[column] <= '3'))
+                {
+                    row_clues[column] = row[column] - '0';
+                }
+                else if (row[column] != '.')
+                {
+                    return false;
+                }
+            }
+            clues.push_back(row_clues);
+        }
+        return static_cast<int>(clues.size()) == rows;
+    }
+
+    bool load_slitherlink_from_device(QIODevice *device, GcClues& clues, bool& single_loop)
+    {
+        bool success = false;
+        QDomDocument dom_document;
+
+        QString errorStr;
+        int errorLine;
+        int errorColumn;
+
+        if (dom_document.setContent(device, true, &errorStr, &errorLine, &errorColumn))
+        {
+            QDomElement root = dom_document.documentElement();
+            if (root.tagName() == "puzzle")
+            {
+                bool found_rows = false;
+                bool found_columns = false;
+                int rows = 0;
+                int columns = 0;
+                QDomElement slitherlink_element;
+                for (QDomElement element = root.firstChildElement(); !element.isNull(); element = element.nextSiblingElement())
+                {
+                    if (element.tagName() == "rows")
+                    {
+                        rows = element.text().toInt(&found_rows);
+                    }
+                    else if (element.tagName() == "columns")
+                    {
+                        columns = element.text().toInt(&found_columns);
+                    }
+                    else if (element.tagName() == "slitherlink")
+                    {
+                        slitherlink_element = element;
+                    }
+                }
+                if (found_rows && found_columns && (rows > 0) && (columns > 0) && !slitherlink_element.isNull())
+                {
+                    single_loop = slitherlink_element.attribute("single_loop", "true") != "false";
+                    QDomElement clues_element = slitherlink_element.firstChildElement("clues");
+                    success = !clues_element.isNull() && parse_clues_from_element(clues_element, rows, columns, clues);
+                }
+            }
+        }
+        else
+        {
+            std::cout << "Parse error at line " << errorLine << ", column "
+                      << errorColumn << ":\n" << errorStr.toStdString() << std::endl;
+        }
+        return success;
+    }
 }
 
 std::unique_ptr<SudokuPuzzle> load_from_file(QFile& file)
@@ -226,5 +307,16 @@ std::unique_ptr<SudokuPuzzle> load_from_file(QFile& file)
     return puzzle;
 }
 
+std::unique_ptr<GcPuzzle> load_slitherlink_from_file(QFile& file)
+{
+    std::unique_ptr<GcPuzzle> puzzle;
+    GcClues clues;
+    bool single_loop = true;
+    if (load_slitherlink_from_device(&file, clues, single_loop))
+    {
+        puzzle = std::unique_ptr<GcPuzzle>(new GcPuzzle(clues, single_loop));
+    }
+    return puzzle;
 }
 
+}
@@ -1,10 +1,25 @@
 #pragma once
 
+#include "gcpuzzle.hpp"
 #include "sudokupuzzle.hpp"
 
 #include <QFile>
 
 namespace PuzzleLoader {
     std::unique_ptr<SudokuPuzzle> load_from_file(QFile& file);
+    // Loads a puzzle with a slitherlink element, for example
+    //  <puzzle>
+    //   <rows>2</rows>
+    //   <columns>3</columns>
+    //   <slitherlink single_loop="true">
+    //    <clues>
+    //     <row>3.2</row>
+    //     <row>..1</row>
+    //    </clues>
+    //   </slitherlink>
+    //  </puzzle>
+    // with a row element of columns characters for every row of cells: the
+    // number of segments around the cell or . for cells without a number.
+    std::unique_ptr<GcPuzzle> load_slitherlink_from_file(QFile& file);
 
 }
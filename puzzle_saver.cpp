@@ -77,8 +77,8 @@ namespace  {
     void append_example(QDomDocument dom_document, QDomElement sudoku_element, const SudokuBoard& example_board)
     {
         QDomElement example_element = dom_document.createElement("example");
-        const int rows = example_board.size();
-        const int columns = example_board[0].size();
+        const int rows = example_board.get_rows();
+        const int columns = example_board.get_columns();
         for (Position row = 0; row < rows ; ++row)
         {
             for (Position column = 0; column < columns; ++column)
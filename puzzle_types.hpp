@@ -30,7 +30,6 @@ enum class PuzzleColor
 
 using Value = int;
 using Position = int;
-using SudokuBoard = std::vector<std::vector<Value>>;
 
 using Point = std::pair<Position, Position>;
 using PointVector = std::vector<Point>;
@@ -48,3 +47,8 @@ struct GcBoard
     GcSegments horizontal_lines;
     GcSegments vertical_lines;
 };
+
+// Number of segments around every cell of a slitherlink like puzzle, row by
+// row, or GC_NO_CLUE for cells without a number
+using GcClues = std::vector<std::vector<int>>;
+const int GC_NO_CLUE = -1;
@@ -0,0 +1,42 @@
+#include "sat_backend.hpp"
+#include "minisat_backend.hpp"
+#ifdef PUZZLE_SOLVER_WITH_IPASIR
+#include "ipasir_backend.hpp"
+#endif
+
+#include <iostream>
+
+bool SatBackend::add_clause(Minisat::Lit literal) {
+    m_short_clause.clear();
+    m_short_clause.push(literal);
+    return add_clause(m_short_clause);
+}
+
+bool SatBackend::add_clause(Minisat::Lit lhs, Minisat::Lit rhs) {
+    m_short_clause.clear();
+    m_short_clause.push(lhs);
+    m_short_clause.push(rhs);
+    return add_clause(m_short_clause);
+}
+
+bool is_sat_backend_available(Settings::Backend backend) {
+#ifdef PUZZLE_SOLVER_WITH_IPASIR
+    (void)backend;
+    return true;
+#else
+    return backend == Settings::Backend::MINISAT;
+#endif
+}
+
+std::unique_ptr<SatBackend> create_sat_backend(Settings::SolverOptions const& solver_options) {
+#ifdef PUZZLE_SOLVER_WITH_IPASIR
+    if (solver_options.backend == Settings::Backend::IPASIR) {
+        return std::make_unique<IpasirBackend>();
+    }
+#else
+    if (solver_options.backend == Settings::Backend::IPASIR) {
+        std::clog << "IPASIR backend not built in, using MiniSat\n";
+    }
+#endif
+    return std::make_unique<MinisatBackend>(solver_options);
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "solver_options.hpp"
+#include "solver_stats.hpp"
+#include <minisat/core/SolverTypes.h>
+#include <minisat/mtl/Vec.h>
+#include <cstdint>
+#include <functional>
+#include <memory>
+
+// Incremental SAT solver that the encoders add their variables and clauses
+// to. Variables and literals are those of MiniSat, whose types every backend
+// shares; a backend translates them to its own numbering.
+class SatBackend {
+public:
+    virtual ~SatBackend() {}
+
+    virtual Minisat::Var new_var() = 0;
+    // Returns false if the clauses are known to be unsatisfiable now. A
+    // backend that only finds out when solving returns false for the empty
+    // clause only.
+    virtual bool add_clause(Minisat::vec<Minisat::Lit> const& literals) = 0;
+    bool add_clause(Minisat::Lit literal);
+    bool add_clause(Minisat::Lit lhs, Minisat::Lit rhs);
+    // Keeps the variable out of preprocessing. Variables that are read from
+    // the model, or occur in clauses or assumptions after the first solve,
+    // have to be frozen. Assumptions of the first solve are frozen anyway.
+    virtual void freeze(Minisat::Var var) = 0;
+
+    // Solves under the assumptions within the budget. Returns undefined if
+    // the budget ran out, terminate returned true or the solve was
+    // interrupted. Fills model after a satisfiable solve.
+    virtual Minisat::lbool solve_limited(Minisat::vec<Minisat::Lit> const& assumptions) = 0;
+    // Limits the conflicts and propagations of the next solves, negative for
+    // no limit. Backends without these counters ignore them.
+    virtual void set_budget(std::int64_t conflicts, std::int64_t propagations) = 0;
+    // Asked now and then during a solve by backends without budgets, which
+    // stop the solve once it returns true. An empty function never stops.
+    virtual void set_terminate(std::function<bool()> terminate) = 0;
+    // Stops a running solve, can be called from any thread
+    virtual void interrupt() = 0;
+    virtual void clear_interrupt() = 0;
+
+    // The size of the encoding and the search effort since construction, as
+    // far as the backend counts them
+    virtual SolverStats get_stats() const = 0;
+
+    Minisat::lbool model_value(Minisat::Var var) const { return model[var]; }
+
+    // The value of every variable in the last satisfiable solve
+    Minisat::vec<Minisat::lbool> model;
+
+private:
+    // Reused by the add_clause overloads for one and two literals
+    Minisat::vec<Minisat::Lit> m_short_clause;
+};
+
+// Returns false if the backend was not built in
+bool is_sat_backend_available(Settings::Backend backend);
+
+// Creates the backend of the solver options, configured with its search
+// heuristics as far as the backend supports them. Backends that were not
+// built in fall back to MiniSat.
+std::unique_ptr<SatBackend> create_sat_backend(Settings::SolverOptions const& solver_options);
@@ -0,0 +1,216 @@
+#pragma once
+
+#include "puzzle_types.hpp"
+#include "sudokuboard.hpp"
+#include <bitset>
+#include <cstdint>
+#include <vector>
+
+class CompiledLayout;
+
+// The tables of BasicSinglePropagation for a layout compiled at runtime, a
+// CompiledLayout with up to 32 values. The candidates and values of a state
+// are vectors with an entry for every cell. Layout is a parameter so that
+// the layout only has to be complete where the propagation is used.
+template <class Layout>
+class RuntimeTables {
+public:
+    using Candidates = std::uint32_t;
+    using CandidateCells = std::vector<Candidates>;
+    using ValueCells = std::vector<Value>;
+
+    explicit RuntimeTables(const Layout& layout)
+        : m_layout(layout)
+    {
+    }
+
+    static bool supports(const Layout& layout) { return layout.get_values() <= 8 * static_cast<int>(sizeof(Candidates)); }
+
+    int values() const { return m_layout.get_values(); }
+    // Zero for every cell
+    CandidateCells make_candidates() const { return CandidateCells(m_layout.get_cells(), 0); }
+    ValueCells make_values() const { return ValueCells(m_layout.get_cells(), 0); }
+    const std::vector<int>& active_cells() const { return m_layout.get_active_cells(); }
+    int active_cell_count() const { return static_cast<int>(m_layout.get_active_cells().size()); }
+    auto peers(int cell) const { return m_layout.get_peers(cell); }
+    int region_count() const { return m_layout.get_region_count(); }
+    auto region(int region) const { return m_layout.get_region(region); }
+
+private:
+    const Layout& m_layout;
+};
+
+// Candidate values of the cells of a layout as bitmasks, narrowed by placing
+// values and by propagating naked and hidden singles to a fixed point. Used
+// by the propagation engine for its search and by the SAT engine to shrink
+// the encoding of a board before it is built. Tables gives the cells,
+// regions and peers of the layout and the types of a state, see
+// RuntimeTables and FixedTables.
+template <class Tables>
+class BasicSinglePropagation {
+public:
+    using Candidates = typename Tables::Candidates;
+    // The most values the candidates of a cell can hold
+    static const int MAX_VALUES = 8 * sizeof(Candidates);
+
+    struct State
+    {
+        typename Tables::CandidateCells candidates;
+        // Zero for cells that have not been assigned yet
+        typename Tables::ValueCells values;
+        int open_cells;
+    };
+
+    // Layouts with more than MAX_VALUES values can be passed, but not
+    // propagated, see supports
+    explicit BasicSinglePropagation(const CompiledLayout& layout)
+        : m_tables(layout)
+        , m_all_candidates(m_tables.values() >= MAX_VALUES ? Candidates(~Candidates(0)) : Candidates((Candidates(1) << m_tables.values()) - 1))
+    {
+    }
+
+    static bool supports(const CompiledLayout& layout) { return Tables::supports(layout); }
+
+    // Every active cell open with every value as candidate
+    State initial_state() const {
+        assert((m_tables.values() <= MAX_VALUES) && "Candidates do not fit in the bitmask");
+        State state;
+        state.candidates = m_tables.make_candidates();
+        state.values = m_tables.make_values();
+        state.open_cells = m_tables.active_cell_count();
+        for (int cell : m_tables.active_cells()) {
+            state.candidates[cell] = m_all_candidates;
+        }
+        return state;
+    }
+
+    // Places the givens of a board and propagates them. Returns false if
+    // givens share a region and a value or propagation runs into a cell or a
+    // region value without candidates.
+    bool apply_givens(State& state, SudokuBoardView board) const {
+        for (int cell : m_tables.active_cells()) {
+            auto value = board.data()[cell];
+            if ((value != 0) && !place(state, cell, value)) {
+                return false;
+            }
+        }
+        return propagate(state);
+    }
+
+    // Both return false on a contradiction, which leaves state undefined
+    bool place(State& state, int cell, Value value) const {
+        const Candidates candidate = Candidates(1) << (value - 1);
+        if ((state.candidates[cell] & candidate) == 0) {
+            return false;
+        }
+        if (state.values[cell] != 0) {
+            return true;
+        }
+        state.values[cell] = static_cast<typename Tables::ValueCells::value_type>(value);
+        state.candidates[cell] = candidate;
+        --state.open_cells;
+        for (int peer : m_tables.peers(cell)) {
+            if ((state.candidates[peer] & candidate) != 0) {
+                if (state.values[peer] != 0) {
+                    return false;
+                }
+                state.candidates[peer] &= ~candidate;
+                if (state.candidates[peer] == 0) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    bool propagate(State& state) const {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            // Naked singles: an open cell with a single candidate left
+            for (int cell : m_tables.active_cells()) {
+                if ((state.values[cell] == 0) && (count(state.candidates[cell]) == 1)) {
+                    if (!place(state, cell, lowest(state.candidates[cell]))) {
+                        return false;
+                    }
+                    changed = true;
+                }
+            }
+            // Hidden singles: a value that fits a single open cell of a region
+            for (int region = 0; region < m_tables.region_count(); ++region) {
+                const auto& region_cells = m_tables.region(region);
+                Candidates placed = 0;
+                Candidates once = 0;
+                Candidates twice = 0;
+                for (int cell : region_cells) {
+                    if (state.values[cell] != 0) {
+                        placed |= state.candidates[cell];
+                    } else {
+                        twice |= once & state.candidates[cell];
+                        once |= state.candidates[cell];
+                    }
+                }
+                if (Candidates(once | placed) != m_all_candidates) {
+                    return false;
+                }
+                Candidates hidden = once & ~twice & ~placed;
+                while (hidden != 0) {
+                    const Candidates candidate = hidden & (~hidden + 1);
+                    hidden &= ~candidate;
+                    for (int cell : region_cells) {
+                        if ((state.values[cell] == 0) && ((state.candidates[cell] & candidate) != 0)) {
+                            if (!place(state, cell, lowest(candidate))) {
+                                return false;
+                            }
+                            changed = true;
+                            break;
+                        }
+                    }
+                }
+            }
+        }
+        return true;
+    }
+
+    // The open cell with the fewest candidates, the first of them on a tie,
+    // or -1 if every cell has a value
+    int fewest_candidates_cell(const State& state) const {
+        int fewest_cell = -1;
+        int fewest_candidates = m_tables.values() + 1;
+        for (int cell : m_tables.active_cells()) {
+            if (state.values[cell] == 0) {
+                const int candidates = count(state.candidates[cell]);
+                if (candidates < fewest_candidates) {
+                    fewest_candidates = candidates;
+                    fewest_cell = cell;
+                }
+            }
+        }
+        return fewest_cell;
+    }
+
+    Candidates get_all_candidates() const { return m_all_candidates; }
+
+    static int count(Candidates candidates) {
+        return static_cast<int>(std::bitset<MAX_VALUES>(candidates).count());
+    }
+
+    // The value of the lowest bit that is set
+    static Value lowest(Candidates candidates) {
+        Value value = 1;
+        while ((candidates & 1) == 0) {
+            candidates >>= 1;
+            ++value;
+        }
+        return value;
+    }
+
+private:
+    const Tables m_tables;
+    const Candidates m_all_candidates;
+};
+
+template <class Tables>
+const int BasicSinglePropagation<Tables>::MAX_VALUES;
+
+using SinglePropagation = BasicSinglePropagation<RuntimeTables<CompiledLayout>>;
@@ -0,0 +1,205 @@
+#include "solve_control.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <condition_variable>
+#include <thread>
+
+namespace SolveControl {
+
+namespace {
+    // Time between two progress reports of a running solve
+    const std::chrono::milliseconds PROGRESS_INTERVAL(100);
+
+    // Reports the progress of a solve and interrupts it at the deadline of
+    // the budget, from its own thread, until it is stopped
+    class Watchdog {
+    public:
+        Watchdog(SatBackend& solver, std::function<void()> const& on_progress, Budget const& budget)
+            : m_solver(solver)
+            , m_on_progress(on_progress)
+            , m_budget(budget)
+            , m_thread(&Watchdog::run, this) {
+        }
+
+        // Returns true if the watchdog interrupted the solver
+        bool stop() {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopped = true;
+            }
+            m_wakeup.notify_one();
+            m_thread.join();
+            return m_fired;
+        }
+
+    private:
+        void run() {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            auto next_report = std::chrono::steady_clock::now() + PROGRESS_INTERVAL;
+            while (!m_stopped) {
+                auto wakeup = m_on_progress ? next_report : m_budget.get_deadline();
+                if (m_budget.has_deadline()) {
+                    wakeup = std::min(wakeup, m_budget.get_deadline());
+                }
+                if (m_wakeup.wait_until(lock, wakeup, [this] { return m_stopped; })) {
+                    break;
+                }
+                if (m_budget.deadline_passed()) {
+                    m_solver.interrupt();
+                    m_fired = true;
+                    break;
+                }
+                if (m_on_progress && (std::chrono::steady_clock::now() >= next_report)) {
+                    // The counters are read while the search changes them
+                    lock.unlock();
+                    m_on_progress();
+                    lock.lock();
+                    next_report += PROGRESS_INTERVAL;
+                }
+            }
+        }
+
+        SatBackend& m_solver;
+        std::function<void()> const& m_on_progress;
+        Budget const& m_budget;
+        std::mutex m_mutex;
+        std::condition_variable m_wakeup;
+        bool m_stopped = false;
+        bool m_fired = false;
+        // Started last, once the members above are set
+        std::thread m_thread;
+    };
+}
+
+Interrupter::Interrupter(SatBackend* solver)
+    : m_solver(solver) {
+}
+
+void Interrupter::interrupt() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_interrupted = true;
+    // Scope passes a held interrupt on to the solver
+    if (m_running && m_solver) {
+        m_solver->interrupt();
+    }
+}
+
+void Interrupter::clear_interrupt() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (!m_running) {
+        m_interrupted = false;
+    }
+}
+
+void Interrupter::set_solver(SatBackend* solver) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    assert(!m_running && "The solver cannot change during a solve");
+    m_solver = solver;
+}
+
+std::atomic<bool> const& Interrupter::interrupted() const {
+    return m_interrupted;
+}
+
+Interrupter::Scope::Scope(Interrupter& interrupter)
+    : m_interrupter(interrupter) {
+    std::lock_guard<std::mutex> lock(m_interrupter.m_mutex);
+    m_interrupter.m_running = true;
+    if (m_interrupter.m_interrupted && m_interrupter.m_solver) {
+        m_interrupter.m_solver->interrupt();
+    }
+}
+
+Interrupter::Scope::~Scope() {
+    std::lock_guard<std::mutex> lock(m_interrupter.m_mutex);
+    m_interrupter.m_running = false;
+    m_interrupter.m_interrupted = false;
+    if (m_interrupter.m_solver) {
+        m_interrupter.m_solver->clear_interrupt();
+    }
+}
+
+Budget::Budget() {
+}
+
+Budget::Budget(SatBackend const& solver, Settings::SolveLimits const& limits) {
+    const SolverStats stats = solver.get_stats();
+    if (limits.time_limit_ms > 0) {
+        m_has_deadline = true;
+        m_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(limits.time_limit_ms);
+    }
+    if (limits.conflict_budget > 0) {
+        m_conflict_limit = static_cast<std::int64_t>(stats.conflicts) + limits.conflict_budget;
+    }
+    if (limits.propagation_budget > 0) {
+        m_propagation_limit = static_cast<std::int64_t>(stats.propagations) + limits.propagation_budget;
+    }
+}
+
+bool Budget::has_deadline() const {
+    return m_has_deadline;
+}
+
+std::chrono::steady_clock::time_point Budget::get_deadline() const {
+    return m_deadline;
+}
+
+bool Budget::deadline_passed() const {
+    return m_has_deadline && (std::chrono::steady_clock::now() >= m_deadline);
+}
+
+bool Budget::exhausted(SatBackend const& solver) const {
+    const SolverStats stats = solver.get_stats();
+    return ((m_conflict_limit >= 0) && (static_cast<std::int64_t>(stats.conflicts) >= m_conflict_limit))
+        || ((m_propagation_limit >= 0) && (static_cast<std::int64_t>(stats.propagations) >= m_propagation_limit))
+        || deadline_passed();
+}
+
+void Budget::apply(SatBackend& solver) const {
+    const SolverStats stats = solver.get_stats();
+    std::int64_t conflicts = -1;
+    if (m_conflict_limit >= 0) {
+        conflicts = std::max<std::int64_t>(m_conflict_limit - static_cast<std::int64_t>(stats.conflicts), 0);
+    }
+    std::int64_t propagations = -1;
+    if (m_propagation_limit >= 0) {
+        propagations = std::max<std::int64_t>(m_propagation_limit - static_cast<std::int64_t>(stats.propagations), 0);
+    }
+    solver.set_budget(conflicts, propagations);
+}
+
+Minisat::lbool solve(SatBackend& solver, Minisat::vec<Minisat::Lit> const& assumptions,
+                     std::atomic<bool> const& interrupted, std::function<void()> const& on_progress,
+                     Budget const& budget) {
+    if (interrupted || budget.exhausted(solver)) {
+        return l_Undef;
+    }
+    budget.apply(solver);
+    // Backends without budgets or interrupts of their own stop through this
+    solver.set_terminate([&]() { return interrupted || budget.deadline_passed(); });
+    Minisat::lbool result;
+    if (on_progress || budget.has_deadline()) {
+        Watchdog watchdog(solver, on_progress, budget);
+        result = solver.solve_limited(assumptions);
+        // An interrupt at the deadline would stop the next solve as well,
+        // one from interrupted is cleared by the Interrupter
+        if (watchdog.stop() && !interrupted) {
+            solver.clear_interrupt();
+        }
+    } else {
+        result = solver.solve_limited(assumptions);
+    }
+    solver.set_budget(-1, -1);
+    solver.set_terminate(std::function<bool()>());
+    return result;
+}
+
+SolveResult to_solve_result(Minisat::lbool result) {
+    if (result.isUndef()) {
+        return SolveResult::UNKNOWN;
+    }
+    return result.isTrue() ? SolveResult::SAT : SolveResult::UNSAT;
+}
+
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "sat_backend.hpp"
+#include "solver_options.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+
+namespace SolveControl {
+
+// The limits of one solve as counter values of the solver and a deadline,
+// so a series of solves, like the subtour rounds of GcSolver, shares them
+class Budget {
+public:
+    // Without limits
+    Budget();
+    // The limits start counting from now
+    Budget(SatBackend const& solver, Settings::SolveLimits const& limits);
+
+    bool has_deadline() const;
+    std::chrono::steady_clock::time_point get_deadline() const;
+    bool deadline_passed() const;
+    bool exhausted(SatBackend const& solver) const;
+    // Sets the budget of the next solve_limited to what is left
+    void apply(SatBackend& solver) const;
+
+private:
+    bool m_has_deadline = false;
+    std::chrono::steady_clock::time_point m_deadline;
+    // Negative without limit
+    std::int64_t m_conflict_limit = -1;
+    std::int64_t m_propagation_limit = -1;
+};
+
+// Lets other threads interrupt the solves of one solver. An interrupt
+// between solves is held and stops the next solve as soon as it starts, so
+// one that arrives just before the solve is not lost. clear_interrupt drops
+// a held interrupt.
+class Interrupter {
+public:
+    // Without solver only the flag is set
+    explicit Interrupter(SatBackend* solver = nullptr);
+    void interrupt();
+    // Drops an interrupt held between solves, has no effect while one runs
+    void clear_interrupt();
+    // Interrupts another solver from now on, only between solves
+    void set_solver(SatBackend* solver);
+    // Set once the running solve is interrupted, or while one is held
+    std::atomic<bool> const& interrupted() const;
+
+    // A solve runs while the scope exists. A held interrupt stops it right
+    // away, the interrupt is cleared at its end.
+    class Scope {
+    public:
+        explicit Scope(Interrupter& interrupter);
+        ~Scope();
+
+    private:
+        Interrupter& m_interrupter;
+    };
+
+private:
+    SatBackend* m_solver;
+    std::mutex m_mutex;
+    bool m_running = false;
+    std::atomic<bool> m_interrupted{false};
+};
+
+// Solves under the assumptions until the solver finds an answer, the budget
+// is exhausted or interrupted is set, which also requires
+// SatBackend::interrupt to stop a running search. The conflict and
+// propagation limits are set once for the whole search, so it keeps its
+// own restart and learnt clause schedule. With on_progress or a deadline a
+// watchdog thread runs next to the search: it calls on_progress now and
+// then and interrupts the solver at the deadline. The result is undefined
+// when it was stopped.
+Minisat::lbool solve(SatBackend& solver, Minisat::vec<Minisat::Lit> const& assumptions,
+                     std::atomic<bool> const& interrupted, std::function<void()> const& on_progress,
+                     Budget const& budget = Budget());
+
+SolveResult to_solve_result(Minisat::lbool result);
+
+}
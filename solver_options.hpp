@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Settings {
+
+enum class AmoEncoding
+{
+    // n*(n-1)/2 binary clauses, no auxiliary variables
+    PAIRWISE,
+    // Sequential counter: 3n-4 clauses, n-1 auxiliary variables
+    SEQUENTIAL,
+    // Commander variables for groups of three literals
+    COMMANDER,
+    // Two dimensional product encoding, about 2n + 4*sqrt(n) clauses
+    PRODUCT,
+    // Binary encoded index of groups of two literals
+    BIMANDER,
+    // Pairwise for small constraints, product encoding for larger ones
+    AUTO,
+};
+
+// SAT solver behind the encodings
+enum class Backend
+{
+    MINISAT,
+    // Any solver implementing the IPASIR incremental interface, linked in at
+    // configure time, see CMakeLists.txt
+    IPASIR,
+};
+
+// Preprocessing of the encoding by MiniSat's SimpSolver before the first
+// solve, with subsumption and bounded variable elimination. Variables that
+// are read back or constrained later are frozen, so only the auxiliary
+// variables of the cardinality encodings can be eliminated.
+enum class Preprocessing
+{
+    NONE,
+    // Only short resolvents and a small subsumption effort
+    LIGHT,
+    // The limits of MiniSat's own preprocessor
+    NORMAL,
+    // Resolvents of any length, elimination may grow the encoding a little,
+    // and asymmetric branching
+    HEAVY,
+};
+
+struct SolverOptions
+{
+    Backend backend = Backend::MINISAT;
+    AmoEncoding amo_encoding = AmoEncoding::AUTO;
+    // Search heuristics of MiniSat, the defaults are those of MiniSat itself.
+    // The seed only matters with random decisions or initial activities.
+    // IPASIR has no way to set them.
+    double random_seed = 91648253;
+    double random_var_freq = 0;
+    bool random_initial_activity = false;
+    // 0 is none, 1 limited and 2 full phase saving
+    int phase_saving = 2;
+    // Luby restarts, otherwise geometric restarts
+    bool luby_restart = true;
+    // Only MiniSat preprocesses, IPASIR solvers simplify on their own
+    Preprocessing preprocessing = Preprocessing::NONE;
+    // Propagate naked and hidden singles from the givens before solving.
+    // apply_board on a new solver then only encodes the open cells and their
+    // candidates, and boards that propagation solves never reach MiniSat.
+    bool presolve = true;
+    // Number of differently configured solvers that race on their own thread
+    // for every solve, see portfolio_options. 1 solves on the calling thread.
+    int portfolio_size = 1;
+};
+
+// Limits of a single solve, a limit of zero is no limit
+struct SolveLimits
+{
+    // Wall-clock time from the start of the solve
+    std::int64_t time_limit_ms = 0;
+    std::int64_t conflict_budget = 0;
+    std::int64_t propagation_budget = 0;
+};
+
+}
+
+// Result of a solve that can run into its limits or be interrupted
+enum class SolveResult
+{
+    SAT,
+    UNSAT,
+    // A limit was reached or the solve was interrupted before an answer
+    UNKNOWN,
+};
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+
+// Size of the encoding and effort of the last solve, to correlate slow
+// puzzles with what the solver had to do for them
+struct SolverStats
+{
+    int variables = 0;
+    int clauses = 0;
+    // Search effort of the last solve or count_solutions
+    std::uint64_t conflicts = 0;
+    std::uint64_t decisions = 0;
+    std::uint64_t propagations = 0;
+    std::uint64_t restarts = 0;
+    // What preprocessing took out of the encoding and how long it took, as
+    // part of the first solve. removed_clauses is negative if elimination
+    // grew the encoding.
+    int eliminated_variables = 0;
+    int removed_clauses = 0;
+    double preprocess_ms = 0.0;
+    // Durations of building the encoding, of the last apply_board or
+    // assume_board and of the last solve or count_solutions
+    double encode_ms = 0.0;
+    double apply_ms = 0.0;
+    double solve_ms = 0.0;
+};
+
+// Receives the statistics of a running solve, on the solving thread or on
+// the watchdog thread of SolveControl::solve
+using ProgressCallback = std::function<void(const SolverStats&)>;
+
+// Stores the time between its construction and destruction in milliseconds
+class ScopedTimer
+{
+public:
+    explicit ScopedTimer(double& elapsed_ms)
+        : m_elapsed_ms(elapsed_ms)
+        , m_start(std::chrono::steady_clock::now())
+    {
+    }
+    ~ScopedTimer()
+    {
+        m_elapsed_ms = elapsed_ms();
+    }
+    double elapsed_ms() const
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+    }
+
+private:
+    double& m_elapsed_ms;
+    const std::chrono::steady_clock::time_point m_start;
+};
+
+// Stores the search effort and time a SAT backend spends between its
+// construction and destruction
+template <class Solver>
+class SolveStatsRecorder
+{
+public:
+    SolveStatsRecorder(const Solver& solver, SolverStats& stats)
+        : m_solver(solver)
+        , m_stats(stats)
+        , m_timer(stats.solve_ms)
+        , m_start(solver.get_stats())
+    {
+    }
+    ~SolveStatsRecorder()
+    {
+        const SolverStats stats = current();
+        m_stats.conflicts = stats.conflicts;
+        m_stats.decisions = stats.decisions;
+        m_stats.propagations = stats.propagations;
+        m_stats.restarts = stats.restarts;
+    }
+
+    // Returns the statistics of the solve so far
+    SolverStats current() const
+    {
+        const SolverStats now = m_solver.get_stats();
+        SolverStats stats = m_stats;
+        stats.variables = now.variables;
+        stats.clauses = now.clauses;
+        stats.eliminated_variables = now.eliminated_variables;
+        stats.removed_clauses = now.removed_clauses;
+        stats.preprocess_ms = now.preprocess_ms;
+        stats.conflicts = now.conflicts - m_start.conflicts;
+        stats.decisions = now.decisions - m_start.decisions;
+        stats.propagations = now.propagations - m_start.propagations;
+        stats.restarts = now.restarts - m_start.restarts;
+        stats.solve_ms = m_timer.elapsed_ms();
+        return stats;
+    }
+
+    // Returns a function that passes the statistics so far to callback, or an
+    // empty function without callback
+    std::function<void()> report_to(ProgressCallback const& callback) const
+    {
+        if (!callback)
+        {
+            return std::function<void()>();
+        }
+        return [this, &callback]() { callback(current()); };
+    }
+
+private:
+    const Solver& m_solver;
+    SolverStats& m_stats;
+    ScopedTimer m_timer;
+    const SolverStats m_start;
+};
@@ -0,0 +1,93 @@
+#pragma once
+
+// Cells of the regions and peers of the standard square sudoku with boxes of
+// Box x Box cells, as built by make_square_tables
+template <int Box>
+struct SquareTables
+{
+    static constexpr int SIZE = Box * Box;
+    static constexpr int CELLS = SIZE * SIZE;
+    static constexpr int REGIONS = 3 * SIZE;
+    // The other cells of the row and of the column, and the cells of the box
+    // outside both
+    static constexpr int PEERS = 2 * (SIZE - 1) + (Box - 1) * (Box - 1);
+
+    // Every cell in order, as all of them are active
+    int cells[CELLS];
+    int regions[REGIONS][SIZE];
+    int peers[CELLS][PEERS];
+};
+
+// The regions are the rows, the columns and the boxes row by row, like in
+// Settings::Sudoku::get_board_settings, and the peers of every cell are in
+// increasing order, like in CompiledLayout
+template <int Box>
+constexpr SquareTables<Box> make_square_tables()
+{
+    using Tables = SquareTables<Box>;
+    Tables tables{};
+    for (int cell = 0; cell < Tables::CELLS; ++cell)
+    {
+        tables.cells[cell] = cell;
+    }
+    for (int i = 0; i < Tables::SIZE; ++i)
+    {
+        const int box_row = Box * (i / Box);
+        const int box_column = Box * (i % Box);
+        for (int j = 0; j < Tables::SIZE; ++j)
+        {
+            tables.regions[i][j] = i * Tables::SIZE + j;
+            tables.regions[Tables::SIZE + i][j] = j * Tables::SIZE + i;
+            tables.regions[2 * Tables::SIZE + i][j] = (box_row + j / Box) * Tables::SIZE + box_column + j % Box;
+        }
+    }
+    for (int cell = 0; cell < Tables::CELLS; ++cell)
+    {
+        const int row = cell / Tables::SIZE;
+        const int column = cell % Tables::SIZE;
+        const int box_column = Box * (column / Box);
+        int peer = 0;
+        for (int r = 0; r < Tables::SIZE; ++r)
+        {
+            if (r == row)
+            {
+                for (int c = 0; c < Tables::SIZE; ++c)
+                {
+                    if (c != column)
+                    {
+                        tables.peers[cell][peer++] = r * Tables::SIZE + c;
+                    }
+                }
+            }
+            else if (r / Box == row / Box)
+            {
+                for (int c = box_column; c < box_column + Box; ++c)
+                {
+                    tables.peers[cell][peer++] = r * Tables::SIZE + c;
+                }
+            }
+            else
+            {
+                tables.peers[cell][peer++] = r * Tables::SIZE + column;
+            }
+        }
+    }
+    return tables;
+}
+
+// The standard square sudoku layouts with their tables computed at compile
+// time, for engines that are specialized for them
+template <int Box>
+struct SquareLayout
+{
+    using Tables = SquareTables<Box>;
+    static constexpr int SIZE = Tables::SIZE;
+    static constexpr int CELLS = Tables::CELLS;
+    static constexpr int REGIONS = Tables::REGIONS;
+    static constexpr int PEERS = Tables::PEERS;
+
+    static constexpr Tables tables = make_square_tables<Box>();
+};
+
+template <int Box>
+constexpr SquareTables<Box> SquareLayout<Box>::tables;
@@ -0,0 +1,129 @@
+#include "sudokubatchsolver.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <deque>
+#include <mutex>
+#include <thread>
+
+struct SudokuBatchSolver::WorkQueue
+{
+    std::mutex mutex;
+    std::deque<size_t> board_indices;
+};
+
+SudokuBatchSolver::SudokuBatchSolver(std::shared_ptr<const CompiledLayout> layout, int thread_count,
+                                     Settings::Sudoku::Engine engine, const Settings::SolverOptions& solver_options)
+    : m_layout(std::move(layout))
+    , m_thread_count(thread_count > 0 ? thread_count : std::max(1, static_cast<int>(std::thread::hardware_concurrency())))
+    , m_engine(engine)
+    , m_solver_options(solver_options)
+{
+    m_solvers.resize(m_thread_count);
+    for (int i = 0; i < m_thread_count; ++i)
+    {
+        m_queues.push_back(std::make_unique<WorkQueue>());
+    }
+}
+
+SudokuBatchSolver::~SudokuBatchSolver()
+{
+}
+
+int SudokuBatchSolver::get_thread_count() const
+{
+    return m_thread_count;
+}
+
+void SudokuBatchSolver::set_solution_limit(int limit)
+{
+    m_solution_limit = std::max(1, limit);
+}
+
+std::vector<SudokuBatchResult> SudokuBatchSolver::solve(const std::vector<SudokuBoard>& boards)
+{
+    std::vector<SudokuBatchResult> results(boards.size());
+    // Every thread starts with a contiguous share of the boards
+    for (int i = 0; i < m_thread_count; ++i)
+    {
+        const size_t begin = boards.size() * i / m_thread_count;
+        const size_t end = boards.size() * (i + 1) / m_thread_count;
+        m_queues[i]->board_indices.clear();
+        for (size_t board_index = begin; board_index < end; ++board_index)
+        {
+            m_queues[i]->board_indices.push_back(board_index);
+        }
+    }
+
+    if (m_thread_count == 1)
+    {
+        solve_from_queues(0, boards, results);
+        return results;
+    }
+    std::vector<std::thread> threads;
+    for (int i = 0; i < m_thread_count; ++i)
+    {
+        threads.emplace_back(&SudokuBatchSolver::solve_from_queues, this, i, std::cref(boards), std::ref(results));
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    return results;
+}
+
+void SudokuBatchSolver::solve_from_queues(int thread_index, const std::vector<SudokuBoard>& boards, std::vector<SudokuBatchResult>& results)
+{
+    auto& solver = m_solvers[thread_index];
+    size_t board_index;
+    while (take_work(thread_index, board_index))
+    {
+        auto t1 = std::chrono::high_resolution_clock::now();
+        if (!solver)
+        {
+            solver = create_sudoku_engine(m_engine, m_layout, m_solver_options);
+        }
+        SudokuBatchResult& result = results[board_index];
+        result.consistent = solver->assume_board(boards[board_index]);
+        if (result.consistent)
+        {
+            result.solutions = (m_solution_limit == 1) ? static_cast<int>(solver->solve()) : solver->count_solutions(m_solution_limit);
+            result.stats = solver->get_stats();
+        }
+        result.solved = result.solutions > 0;
+        if (result.solved)
+        {
+            result.solution = solver->get_solution();
+        }
+        std::chrono::duration<double, std::milli> time_taken = std::chrono::high_resolution_clock::now() - t1;
+        result.time_ms = time_taken.count();
+    }
+}
+
+bool SudokuBatchSolver::take_work(int thread_index, size_t& board_index)
+{
+    // Own work is taken from the front, stolen work from the back of the
+    // queue of another thread, so owner and thief rarely meet.
+    {
+        WorkQueue& own_queue = *m_queues[thread_index];
+        std::lock_guard<std::mutex> lock(own_queue.mutex);
+        if (!own_queue.board_indices.empty())
+        {
+            board_index = own_queue.board_indices.front();
+            own_queue.board_indices.pop_front();
+            return true;
+        }
+    }
+    for (int offset = 1; offset < m_thread_count; ++offset)
+    {
+        WorkQueue& victim_queue = *m_queues[(thread_index + offset) % m_thread_count];
+        std::lock_guard<std::mutex> lock(victim_queue.mutex);
+        if (!victim_queue.board_indices.empty())
+        {
+            board_index = victim_queue.board_indices.back();
+            victim_queue.board_indices.pop_back();
+            return true;
+        }
+    }
+    return false;
+}
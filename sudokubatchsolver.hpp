@@ -0,0 +1,58 @@
+#pragma once
+
+#include "compiledlayout.hpp"
+#include "puzzle_types.hpp"
+#include "sudokuengine.hpp"
+#include "sudokusolver.hpp"
+#include <memory>
+#include <vector>
+
+struct SudokuBatchResult
+{
+    // False if the givens of the board contradict each other
+    bool consistent = false;
+    bool solved = false;
+    // Number of solutions found, up to the solution limit
+    int solutions = 0;
+    SudokuBoard solution;
+    double time_ms = 0.0;
+    // Statistics of the solve, only filled in for consistent boards. The
+    // encoding is built once per thread, so encode_ms is shared by all
+    // boards solved by the same thread.
+    SolverStats stats;
+};
+
+// Solves many boards of the same layout on a pool of threads. Every thread
+// owns an engine that is built once and reused for all boards it takes,
+// and takes boards from its own queue first before stealing from the others.
+class SudokuBatchSolver
+{
+public:
+    // A thread_count of 0 uses one thread per hardware thread
+    SudokuBatchSolver(std::shared_ptr<const CompiledLayout> layout, int thread_count = 0,
+                      Settings::Sudoku::Engine engine = Settings::Sudoku::Engine::MINISAT,
+                      const Settings::SolverOptions& solver_options = Settings::SolverOptions());
+    ~SudokuBatchSolver();
+
+    int get_thread_count() const;
+    // Counts the solutions of every board up to limit instead of stopping at
+    // the first one, e.g. a limit of 2 checks that the solution is unique.
+    void set_solution_limit(int limit);
+
+    // Returns the results in the order of the provided boards
+    std::vector<SudokuBatchResult> solve(const std::vector<SudokuBoard>& boards);
+
+private:
+    struct WorkQueue;
+
+    void solve_from_queues(int thread_index, const std::vector<SudokuBoard>& boards, std::vector<SudokuBatchResult>& results);
+    bool take_work(int thread_index, size_t& board_index);
+
+    const std::shared_ptr<const CompiledLayout> m_layout;
+    const int m_thread_count;
+    const Settings::Sudoku::Engine m_engine;
+    const Settings::SolverOptions m_solver_options;
+    int m_solution_limit = 1;
+    std::vector<std::unique_ptr<SudokuEngine>> m_solvers;
+    std::vector<std::unique_ptr<WorkQueue>> m_queues;
+};
@@ -0,0 +1,119 @@
+#pragma once
+
+#include "puzzle_types.hpp"
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+using Square = std::uint8_t;
+
+// Read only view of the squares of a board, row by row, that does not own
+// them. board[row][column] works like for SudokuBoard.
+class SudokuBoardView
+{
+public:
+    SudokuBoardView(const Square* squares, Position rows, Position columns)
+        : m_squares(squares)
+        , m_rows(rows)
+        , m_columns(columns)
+    {
+    }
+
+    Position get_rows() const { return m_rows; }
+    Position get_columns() const { return m_columns; }
+    int size() const { return m_rows * m_columns; }
+
+    const Square* operator[](Position row) const { return m_squares + row * m_columns; }
+    // The square of row * columns + column
+    const Square* data() const { return m_squares; }
+    const Square* begin() const { return m_squares; }
+    const Square* end() const { return m_squares + size(); }
+
+private:
+    const Square* m_squares;
+    Position m_rows;
+    Position m_columns;
+};
+
+// Values of the squares of a board in one allocation, row by row, with 0
+// for an empty square. A square holds values up to 255.
+class SudokuBoard
+{
+public:
+    SudokuBoard()
+    {
+    }
+
+    // A board with only empty squares
+    SudokuBoard(Position rows, Position columns)
+        : m_rows(rows)
+        , m_columns(columns)
+        , m_squares(rows * columns, 0)
+    {
+    }
+
+    explicit SudokuBoard(SudokuBoardView view)
+        : m_rows(view.get_rows())
+        , m_columns(view.get_columns())
+        , m_squares(view.begin(), view.end())
+    {
+    }
+
+    // Conversion from and to the nested vectors the board used to be
+    static SudokuBoard from_rows(const std::vector<std::vector<Value>>& rows)
+    {
+        SudokuBoard board(rows.size(), rows.empty() ? 0 : rows.front().size());
+        for (Position row = 0; row < board.m_rows; ++row)
+        {
+            assert(static_cast<Position>(rows[row].size()) == board.m_columns);
+            for (Position column = 0; column < board.m_columns; ++column)
+            {
+                board[row][column] = rows[row][column];
+            }
+        }
+        return board;
+    }
+
+    std::vector<std::vector<Value>> to_rows() const
+    {
+        std::vector<std::vector<Value>> rows(m_rows);
+        for (Position row = 0; row < m_rows; ++row)
+        {
+            rows[row].assign((*this)[row], (*this)[row] + m_columns);
+        }
+        return rows;
+    }
+
+    operator SudokuBoardView() const
+    {
+        return SudokuBoardView(m_squares.data(), m_rows, m_columns);
+    }
+
+    Position get_rows() const { return m_rows; }
+    Position get_columns() const { return m_columns; }
+    int size() const { return m_rows * m_columns; }
+
+    Square* operator[](Position row) { return m_squares.data() + row * m_columns; }
+    const Square* operator[](Position row) const { return m_squares.data() + row * m_columns; }
+    // The square of row * columns + column
+    Square* data() { return m_squares.data(); }
+    const Square* data() const { return m_squares.data(); }
+    Square* begin() { return m_squares.data(); }
+    Square* end() { return m_squares.data() + m_squares.size(); }
+    const Square* begin() const { return m_squares.data(); }
+    const Square* end() const { return m_squares.data() + m_squares.size(); }
+
+    bool operator==(const SudokuBoard& other) const
+    {
+        return (m_rows == other.m_rows) && (m_columns == other.m_columns) && (m_squares == other.m_squares);
+    }
+    bool operator!=(const SudokuBoard& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    Position m_rows = 0;
+    Position m_columns = 0;
+    std::vector<Square> m_squares;
+};
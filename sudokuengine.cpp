@@ -0,0 +1,22 @@
+#include "sudokuengine.hpp"
+#include "compiledlayout.hpp"
+#include "portfoliosolver.hpp"
+#include "propagationsolver.hpp"
+#include "single_propagation.hpp"
+#include "sudokusolver.hpp"
+
+std::unique_ptr<SudokuEngine> create_sudoku_engine(Settings::Sudoku::Engine engine, const std::shared_ptr<const CompiledLayout>& layout,
+                                                   const Settings::SolverOptions& solver_options)
+{
+    // The candidates of the propagation engine only hold up to 32 values,
+    // larger layouts are solved by MiniSat instead
+    if ((engine == Settings::Sudoku::Engine::PROPAGATION) && SinglePropagation::supports(*layout))
+    {
+        return create_propagation_solver(layout);
+    }
+    if (solver_options.portfolio_size > 1)
+    {
+        return std::make_unique<PortfolioSolver>(layout, solver_options);
+    }
+    return std::make_unique<SudokuSolver>(layout, solver_options);
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "puzzle_types.hpp"
+#include "solver_options.hpp"
+#include "solver_stats.hpp"
+#include "sudokuboard.hpp"
+#include <memory>
+
+namespace Settings {
+namespace Sudoku {
+
+enum class Engine
+{
+    // CNF encoding solved by MiniSat
+    MINISAT,
+    // Candidate bitmasks with single propagation and backtracking
+    PROPAGATION,
+};
+
+}
+}
+
+class CompiledLayout;
+
+// Common interface of the engines that can solve a sudoku of any layout
+class SudokuEngine {
+public:
+    virtual ~SudokuEngine() {}
+    // Returns true if the provided board satisfies the constraints. The
+    // givens of an earlier assume_board no longer hold afterwards.
+    virtual bool apply_board(SudokuBoardView) = 0;
+    // Replaces the givens of the previous board by the givens of the provided
+    // board, reusing whatever the engine derived from the layout itself.
+    // Returns false if the givens are found to contradict each other.
+    virtual bool assume_board(SudokuBoardView) = 0;
+    // Returns true if the sudoku has a solution
+    virtual bool solve() = 0;
+    // Like solve, but gives up with UNKNOWN once one of the limits is reached
+    virtual SolveResult solve_limited(Settings::SolveLimits const& limits) = 0;
+    // Returns the number of solutions, but stops counting at limit. After
+    // counting, get_solution returns the first solution that was found.
+    virtual int count_solutions(int limit) = 0;
+    virtual SudokuBoard get_solution() const = 0;
+    virtual SolverStats get_stats() const = 0;
+    // The callback is called now and then during solve and count_solutions
+    virtual void set_progress_callback(ProgressCallback callback) = 0;
+    // Stops a running solve or count_solutions from another thread, which
+    // then report no (further) solutions. An interrupt between solves stops
+    // the next one.
+    virtual void interrupt() = 0;
+    // Drops an interrupt that arrived between solves
+    virtual void clear_interrupt() = 0;
+};
+
+// The solver options only apply to the MiniSat engine. Layouts with more
+// values than the propagation engine supports always get the MiniSat engine.
+std::unique_ptr<SudokuEngine> create_sudoku_engine(Settings::Sudoku::Engine engine, const std::shared_ptr<const CompiledLayout>& layout,
+                                                   const Settings::SolverOptions& solver_options = Settings::SolverOptions());
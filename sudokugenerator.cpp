@@ -0,0 +1,280 @@
+#include "sudokugenerator.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <numeric>
+#include <thread>
+
+namespace {
+    // Squares that get a random value checked by the solver before the rest
+    // of the solution is filled in
+    const int RANDOM_SQUARES_PER_VALUE = 1;
+}
+
+// Tests removals of givens on threads that live as long as the generator.
+// The thread that calls check takes part as thread 0, and every thread
+// solves with its own session.
+class SudokuGenerator::RemovalPool
+{
+public:
+    explicit RemovalPool(SudokuGenerator& generator)
+        : m_generator(generator)
+    {
+        for (int i = 1; i < m_generator.m_thread_count; ++i)
+        {
+            m_threads.emplace_back(&RemovalPool::run, this, i);
+        }
+    }
+
+    ~RemovalPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_work_ready.notify_all();
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    // Sets unique[i] to whether the solution of the board stays unique
+    // without the given at points[i]
+    void check(const SudokuBoard& board, const std::vector<Point>& points, std::vector<char>& unique)
+    {
+        unique.assign(points.size(), 0);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_board = &board;
+            m_points = &points;
+            m_unique = &unique;
+            m_next_point = 0;
+            m_busy_threads = static_cast<int>(m_threads.size());
+            ++m_batch;
+        }
+        m_work_ready.notify_all();
+        work(0);
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_work_done.wait(lock, [this]() { return m_busy_threads == 0; });
+    }
+
+private:
+    void run(int thread_index)
+    {
+        unsigned int batch = 0;
+        std::unique_lock<std::mutex> lock(m_mutex);
+        while (true)
+        {
+            m_work_ready.wait(lock, [this, batch]() { return m_stopping || (m_batch != batch); });
+            if (m_stopping)
+            {
+                return;
+            }
+            batch = m_batch;
+            lock.unlock();
+            work(thread_index);
+            lock.lock();
+            if (--m_busy_threads == 0)
+            {
+                m_work_done.notify_one();
+            }
+        }
+    }
+
+    void work(int thread_index)
+    {
+        while (true)
+        {
+            size_t index;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_next_point == m_points->size())
+                {
+                    return;
+                }
+                index = m_next_point++;
+            }
+            (*m_unique)[index] = m_generator.is_unique_without(thread_index, *m_board, (*m_points)[index]);
+        }
+    }
+
+    SudokuGenerator& m_generator;
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_work_ready;
+    std::condition_variable m_work_done;
+    // The batch being checked, counted up for every call of check
+    unsigned int m_batch = 0;
+    const SudokuBoard* m_board = nullptr;
+    const std::vector<Point>* m_points = nullptr;
+    std::vector<char>* m_unique = nullptr;
+    size_t m_next_point = 0;
+    // Pool threads that have not finished the batch yet
+    int m_busy_threads = 0;
+    bool m_stopping = false;
+};
+
+SudokuGenerator::SudokuGenerator(std::shared_ptr<const CompiledLayout> layout, unsigned int seed, int thread_count,
+                                 Settings::Sudoku::Engine engine, const Settings::SolverOptions& solver_options)
+    : m_layout(std::move(layout))
+    , m_board_settings(m_layout->get_board_settings())
+    , m_thread_count(thread_count > 0 ? thread_count : std::max(1, static_cast<int>(std::thread::hardware_concurrency())))
+    , m_engine(engine)
+    , m_solver_options(solver_options)
+    , m_random(seed)
+{
+    m_sessions.resize(m_thread_count);
+}
+
+SudokuGenerator::~SudokuGenerator()
+{
+}
+
+SudokuSession& SudokuGenerator::get_session(int thread_index)
+{
+    if (!m_sessions[thread_index])
+    {
+        m_sessions[thread_index] = std::make_unique<SudokuSession>(m_layout, m_engine, m_solver_options);
+    }
+    return *m_sessions[thread_index];
+}
+
+SudokuBoard SudokuGenerator::generate_solution()
+{
+    SudokuSession& session = get_session(0);
+    SudokuBoard board(m_board_settings.rows, m_board_settings.columns);
+    std::vector<Value> values(m_board_settings.values);
+    std::iota(values.begin(), values.end(), 1);
+
+    // Every solution stays a solution when its values are permuted, so any
+    // permutation of the values fits the first region.
+    if (!m_board_settings.regions.empty())
+    {
+        std::shuffle(values.begin(), values.end(), m_random);
+        const PointVector& first_region = m_board_settings.regions.front().first;
+        for (size_t i = 0; (i < first_region.size()) && (i < values.size()); ++i)
+        {
+            board[first_region[i].first][first_region[i].second] = values[i];
+        }
+    }
+
+    // Fix a few more random squares to random values that keep it solvable
+    PointVector open_points;
+    for (Position row = 0; row < m_board_settings.rows; ++row)
+    {
+        for (Position column = 0; column < m_board_settings.columns; ++column)
+        {
+            if ((board[row][column] == 0) && m_layout->is_used(m_layout->to_cell(row, column)))
+            {
+                open_points.emplace_back(row, column);
+            }
+        }
+    }
+    std::shuffle(open_points.begin(), open_points.end(), m_random);
+    const size_t random_squares = std::min(open_points.size(), static_cast<size_t>(RANDOM_SQUARES_PER_VALUE * m_board_settings.values));
+    session.set_givens(board);
+    for (size_t i = 0; i < random_squares; ++i)
+    {
+        const Point& point = open_points[i];
+        std::shuffle(values.begin(), values.end(), m_random);
+        for (Value value : values)
+        {
+            session.set_given(point.first, point.second, value);
+            if (session.solve())
+            {
+                break;
+            }
+            session.clear_given(point.first, point.second);
+        }
+    }
+
+    if (!session.solve())
+    {
+        return board;
+    }
+    SudokuBoard solution = session.get_solution();
+    for (const Point& point : m_board_settings.empty_points)
+    {
+        solution[point.first][point.second] = 0;
+    }
+    return solution;
+}
+
+bool SudokuGenerator::is_unique_without(int thread_index, const SudokuBoard& board, const Point& point)
+{
+    SudokuSession& session = get_session(thread_index);
+    session.set_givens(board);
+    session.clear_given(point.first, point.second);
+    return session.is_unique();
+}
+
+SudokuBoard SudokuGenerator::reduce(const SudokuBoard& board, int target_clues)
+{
+    SudokuBoard puzzle = board;
+    std::vector<Point> candidates;
+    int clues = 0;
+    for (Position row = 0; row < m_board_settings.rows; ++row)
+    {
+        for (Position column = 0; column < m_board_settings.columns; ++column)
+        {
+            if (puzzle[row][column] != 0)
+            {
+                candidates.emplace_back(row, column);
+                ++clues;
+            }
+        }
+    }
+    std::shuffle(candidates.begin(), candidates.end(), m_random);
+    if (!m_pool)
+    {
+        m_pool = std::make_unique<RemovalPool>(*this);
+    }
+
+    // Every batch of one candidate per thread is tested against the puzzle
+    // at once. The first successful removal is applied, and the other
+    // successes were tested against the old puzzle, so only they are tested
+    // again against the new one, until none is left. A failed removal also
+    // fails for any puzzle with fewer givens, so it is dropped.
+    size_t next_candidate = 0;
+    std::vector<Point> batch;
+    std::vector<char> unique;
+    while (clues > target_clues)
+    {
+        if (batch.empty())
+        {
+            const size_t batch_end = std::min(candidates.size(), next_candidate + static_cast<size_t>(m_thread_count));
+            batch.assign(candidates.begin() + next_candidate, candidates.begin() + batch_end);
+            next_candidate = batch_end;
+            if (batch.empty())
+            {
+                break;
+            }
+        }
+        m_pool->check(puzzle, batch, unique);
+
+        std::vector<Point> retest;
+        bool removed = false;
+        for (size_t i = 0; i < batch.size(); ++i)
+        {
+            if (unique[i] && !removed)
+            {
+                puzzle[batch[i].first][batch[i].second] = 0;
+                --clues;
+                removed = true;
+            }
+            else if (unique[i])
+            {
+                retest.push_back(batch[i]);
+            }
+        }
+        batch.swap(retest);
+    }
+    return puzzle;
+}
+
+SudokuBoard SudokuGenerator::generate(int target_clues)
+{
+    return reduce(generate_solution(), target_clues);
+}
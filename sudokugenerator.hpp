@@ -0,0 +1,48 @@
+#pragma once
+
+#include "compiledlayout.hpp"
+#include "puzzle_types.hpp"
+#include "solver_options.hpp"
+#include "sudokuengine.hpp"
+#include "sudokusession.hpp"
+#include "sudokusolver.hpp"
+#include <memory>
+#include <random>
+#include <vector>
+
+// Generates puzzles with a unique solution for any board layout. The same
+// seed and thread count always produce the same puzzles.
+class SudokuGenerator
+{
+public:
+    // A thread_count of 0 uses one thread per hardware thread
+    SudokuGenerator(std::shared_ptr<const CompiledLayout> layout, unsigned int seed, int thread_count = 0,
+                    Settings::Sudoku::Engine engine = Settings::Sudoku::Engine::MINISAT,
+                    const Settings::SolverOptions& solver_options = Settings::SolverOptions());
+    virtual ~SudokuGenerator();
+
+    // Returns a random completely filled board
+    SudokuBoard generate_solution();
+    // Removes givens of the board as long as its solution stays unique,
+    // stopping once target_clues givens are left. With a target of 0 the
+    // result is minimal: removing any other given breaks uniqueness.
+    SudokuBoard reduce(const SudokuBoard& board, int target_clues = 0);
+    // Returns a random puzzle with a unique solution
+    SudokuBoard generate(int target_clues = 0);
+
+private:
+    class RemovalPool;
+
+    SudokuSession& get_session(int thread_index);
+    bool is_unique_without(int thread_index, const SudokuBoard& board, const Point& point);
+
+    const std::shared_ptr<const CompiledLayout> m_layout;
+    const Settings::Sudoku::BoardSettings& m_board_settings;
+    const int m_thread_count;
+    const Settings::Sudoku::Engine m_engine;
+    const Settings::SolverOptions m_solver_options;
+    std::mt19937 m_random;
+    std::vector<std::unique_ptr<SudokuSession>> m_sessions;
+    // Built by the first reduce, after the sessions so it stops first
+    std::unique_ptr<RemovalPool> m_pool;
+};
@@ -11,12 +11,12 @@ const std::map<Settings::PuzzleType, Settings::Sudoku::Type> SUDOKU_TYPES {
 }
 
 SudokuPuzzle::SudokuPuzzle(Settings::PuzzleType predefined_puzzle_type)
-    : m_board_settings(Settings::Sudoku::get_board_settings(SUDOKU_TYPES.at(predefined_puzzle_type)))
+    : m_layout(CompiledLayout::get(SUDOKU_TYPES.at(predefined_puzzle_type)))
 {
 }
 
 SudokuPuzzle::SudokuPuzzle(const Settings::Sudoku::BoardSettings& board_settings)
-    : m_board_settings(board_settings)
+    : m_layout(CompiledLayout::compile(board_settings))
 {
 }
 
@@ -26,44 +26,84 @@ SudokuPuzzle::~SudokuPuzzle()
 
 int SudokuPuzzle::get_values() const
 {
-    return m_board_settings.values;
+    return m_layout->get_values();
 }
 
 int SudokuPuzzle::get_rows() const
 {
-    return m_board_settings.rows;
+    return m_layout->get_rows();
 }
 
 int SudokuPuzzle::get_columns() const
 {
-    return m_board_settings.columns;
+    return m_layout->get_columns();
 }
 
-RegionVector SudokuPuzzle::get_regions() const
+const RegionVector& SudokuPuzzle::get_regions() const
 {
-    return m_board_settings.regions;
+    return get_board_settings().regions;
 }
 
 void SudokuPuzzle::replace_region(int i, Region& region)
 {
-    assert((i >= 0) && (i < m_board_settings.regions.size()));
-    m_board_settings.regions[i] = region;
+    assert((i >= 0) && (i < get_board_settings().regions.size()));
+    Settings::Sudoku::BoardSettings board_settings = get_board_settings();
+    board_settings.regions[i] = region;
+    m_layout = CompiledLayout::compile(std::move(board_settings));
+    m_solver.reset();
+    m_session.reset();
 }
 
 void SudokuPuzzle::remove_region(int i)
 {
-    assert((i >= 0) && (i < m_board_settings.regions.size()));
-    m_board_settings.regions.erase(m_board_settings.regions.begin() +  i);
+    assert((i >= 0) && (i < get_board_settings().regions.size()));
+    Settings::Sudoku::BoardSettings board_settings = get_board_settings();
+    board_settings.regions.erase(board_settings.regions.begin() +  i);
+    m_layout = CompiledLayout::compile(std::move(board_settings));
+    m_solver.reset();
+    m_session.reset();
 }
 
 void SudokuPuzzle::add_region(Region& region)
 {
-    m_board_settings.regions.push_back(region);
+    Settings::Sudoku::BoardSettings board_settings = get_board_settings();
+    board_settings.regions.push_back(region);
+    m_layout = CompiledLayout::compile(std::move(board_settings));
+    m_solver.reset();
+    m_session.reset();
 }
 
-bool SudokuPuzzle::apply_board(const SudokuBoard& board)
+void SudokuPuzzle::set_engine(Settings::Sudoku::Engine engine)
 {
-    m_solver = std::make_unique<SudokuSolver>(m_board_settings);
+    m_engine = engine;
+    m_solver.reset();
+    m_session.reset();
+}
+
+void SudokuPuzzle::set_solver_options(const Settings::SolverOptions& solver_options)
+{
+    m_solver_options = solver_options;
+    m_solver.reset();
+    m_session.reset();
+}
+
+void SudokuPuzzle::set_reuse_encoding(bool reuse_encoding)
+{
+    m_reuse_encoding = reuse_encoding;
+    m_solver.reset();
+}
+
+bool SudokuPuzzle::apply_board(SudokuBoardView board)
+{
+    if (m_reuse_encoding)
+    {
+        if (!m_solver)
+        {
+            m_solver = create_sudoku_engine(m_engine, m_layout, m_solver_options);
+        }
+        return m_solver->assume_board(board);
+    }
+    m_solver = create_sudoku_engine(m_engine, m_layout, m_solver_options);
     return m_solver->apply_board(board);
 }
 
@@ -74,29 +114,69 @@ bool SudokuPuzzle::solve()
     return m_solver->solve();
 }
 
+SolveResult SudokuPuzzle::solve_limited(const Settings::SolveLimits& limits)
+{
+    if (!m_solver)
+        return SolveResult::UNSAT;
+    return m_solver->solve_limited(limits);
+}
+
+int SudokuPuzzle::count_solutions(int limit)
+{
+    if (!m_solver)
+        return 0;
+    return m_solver->count_solutions(limit);
+}
+
+bool SudokuPuzzle::is_unique()
+{
+    return count_solutions(2) == 1;
+}
+
 SudokuBoard SudokuPuzzle::get_solution() const
 {
     if (!m_solver)
-        return SudokuBoard(m_board_settings.rows, std::vector<Value>(m_board_settings.columns));
+        return SudokuBoard(m_layout->get_rows(), m_layout->get_columns());
     return m_solver->get_solution();
 }
 
+SolverStats SudokuPuzzle::get_stats() const
+{
+    if (!m_solver)
+        return SolverStats();
+    return m_solver->get_stats();
+}
+
+SudokuSession& SudokuPuzzle::get_session()
+{
+    if (!m_session)
+    {
+        m_session = std::make_unique<SudokuSession>(m_layout, m_engine, m_solver_options);
+    }
+    return *m_session;
+}
+
 bool SudokuPuzzle::has_example() const
 {
-    return m_board_settings.has_example;
+    return get_board_settings().has_example;
 }
 
 SudokuBoard SudokuPuzzle::get_example() const
 {
-    SudokuBoard board(m_board_settings.rows, std::vector<Value>(m_board_settings.columns));
-    for (auto examplePoint : m_board_settings.example)
+    SudokuBoard board(m_layout->get_rows(), m_layout->get_columns());
+    for (auto examplePoint : get_board_settings().example)
     {
         board[examplePoint.first.first][examplePoint.first.second] = examplePoint.second;
     }
     return board;
 }
 
-Settings::Sudoku::BoardSettings SudokuPuzzle::get_board_settings()
+const Settings::Sudoku::BoardSettings& SudokuPuzzle::get_board_settings() const
+{
+    return m_layout->get_board_settings();
+}
+
+const std::shared_ptr<const CompiledLayout>& SudokuPuzzle::get_layout() const
 {
-    return m_board_settings;
+    return m_layout;
 }
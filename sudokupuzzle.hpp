@@ -1,6 +1,9 @@
 #pragma once
 
+#include "compiledlayout.hpp"
 #include "puzzle_types.hpp"
+#include "sudokuengine.hpp"
+#include "sudokusession.hpp"
 #include "sudokusolver.hpp"
 #include <memory>
 
@@ -14,25 +17,53 @@ public:
     int get_values() const;
     int get_rows() const;
     int get_columns() const;
-    RegionVector get_regions() const;
+    const RegionVector& get_regions() const;
 
     void replace_region(int i, Region& region);
     void remove_region(int i);
     void add_region(Region& region);
 
+    // Selects the engine used by the following apply_board
+    void set_engine(Settings::Sudoku::Engine engine);
+    // Selects the encoding options used by the following apply_board
+    void set_solver_options(const Settings::SolverOptions& solver_options);
+
+    // When enabled, the encoding of the regions is built once and reused by
+    // every following apply_board, which then passes the givens as assumptions.
+    void set_reuse_encoding(bool reuse_encoding);
+
     // Returns true if the provided board satisfies the puzzle constraints
-    bool apply_board(const SudokuBoard& board);
+    bool apply_board(SudokuBoardView board);
     // Returns true if the puzzle has a solution
     bool solve();
+    // Like solve, but gives up with UNKNOWN once one of the limits is reached,
+    // so one hard board cannot block the caller indefinitely
+    SolveResult solve_limited(const Settings::SolveLimits& limits);
+    // Returns the number of solutions of the applied board, up to limit
+    int count_solutions(int limit);
+    // Returns true if the applied board has exactly one solution
+    bool is_unique();
     SudokuBoard get_solution() const;
+    // Returns the statistics of the last apply_board and solve
+    SolverStats get_stats() const;
+
+    // Returns the incremental session of the puzzle, creating it on first use.
+    // The session is discarded when the regions, engine or options change.
+    SudokuSession& get_session();
 
     bool has_example() const;
     SudokuBoard get_example() const;
 
-    Settings::Sudoku::BoardSettings get_board_settings();
+    const Settings::Sudoku::BoardSettings& get_board_settings() const;
+    // The layout is shared with the engines and replaced when a region changes
+    const std::shared_ptr<const CompiledLayout>& get_layout() const;
 
 private:
-    Settings::Sudoku::BoardSettings m_board_settings;
+    std::shared_ptr<const CompiledLayout> m_layout;
+    Settings::Sudoku::Engine m_engine = Settings::Sudoku::Engine::MINISAT;
+    Settings::SolverOptions m_solver_options;
+    bool m_reuse_encoding = false;
 
-    std::unique_ptr<SudokuSolver> m_solver;
+    std::unique_ptr<SudokuEngine> m_solver;
+    std::unique_ptr<SudokuSession> m_session;
 };
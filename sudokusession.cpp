@@ -0,0 +1,107 @@
+#include "sudokusession.hpp"
+
+SudokuSession::SudokuSession(const std::shared_ptr<const CompiledLayout>& layout, Settings::Sudoku::Engine engine,
+                             const Settings::SolverOptions& solver_options)
+    : m_engine(create_sudoku_engine(engine, layout, solver_options))
+    , m_givens(layout->get_rows(), layout->get_columns())
+{
+}
+
+SudokuSession::~SudokuSession()
+{
+}
+
+void SudokuSession::set_given(Position row, Position column, Value value)
+{
+    assert((row >= 0) && (row < m_givens.get_rows()) && (column >= 0) && (column < m_givens.get_columns()));
+    if (m_givens[row][column] != value)
+    {
+        m_givens[row][column] = value;
+        m_givens_changed = true;
+    }
+}
+
+void SudokuSession::clear_given(Position row, Position column)
+{
+    set_given(row, column, 0);
+}
+
+void SudokuSession::set_givens(SudokuBoardView board)
+{
+    assert((board.get_rows() == m_givens.get_rows()) && (board.get_columns() == m_givens.get_columns()));
+    for (Position row = 0; row < m_givens.get_rows(); ++row)
+    {
+        for (Position column = 0; column < m_givens.get_columns(); ++column)
+        {
+            set_given(row, column, board[row][column]);
+        }
+    }
+}
+
+const SudokuBoard& SudokuSession::get_givens() const
+{
+    return m_givens;
+}
+
+bool SudokuSession::is_consistent()
+{
+    update_assumptions();
+    return m_consistent;
+}
+
+bool SudokuSession::solve()
+{
+    update_assumptions();
+    return m_consistent && m_engine->solve();
+}
+
+SolveResult SudokuSession::solve_limited(const Settings::SolveLimits& limits)
+{
+    update_assumptions();
+    return m_consistent ? m_engine->solve_limited(limits) : SolveResult::UNSAT;
+}
+
+int SudokuSession::count_solutions(int limit)
+{
+    update_assumptions();
+    return m_consistent ? m_engine->count_solutions(limit) : 0;
+}
+
+bool SudokuSession::is_unique()
+{
+    return count_solutions(2) == 1;
+}
+
+SudokuBoard SudokuSession::get_solution() const
+{
+    return m_engine->get_solution();
+}
+
+SolverStats SudokuSession::get_stats() const
+{
+    return m_engine->get_stats();
+}
+
+void SudokuSession::set_progress_callback(ProgressCallback callback)
+{
+    m_engine->set_progress_callback(callback);
+}
+
+void SudokuSession::interrupt()
+{
+    m_engine->interrupt();
+}
+
+void SudokuSession::clear_interrupt()
+{
+    m_engine->clear_interrupt();
+}
+
+void SudokuSession::update_assumptions()
+{
+    if (m_givens_changed)
+    {
+        m_consistent = m_engine->assume_board(m_givens);
+        m_givens_changed = false;
+    }
+}
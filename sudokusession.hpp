@@ -0,0 +1,55 @@
+#pragma once
+
+#include "compiledlayout.hpp"
+#include "puzzle_types.hpp"
+#include "solver_options.hpp"
+#include "sudokuengine.hpp"
+#include "sudokusolver.hpp"
+#include <memory>
+
+// Keeps one engine, including everything it learned, alive across edits of
+// the givens. Givens are passed as assumptions, so changing them never
+// rebuilds the encoding.
+class SudokuSession
+{
+public:
+    SudokuSession(const std::shared_ptr<const CompiledLayout>& layout, Settings::Sudoku::Engine engine,
+                  const Settings::SolverOptions& solver_options);
+    virtual ~SudokuSession();
+
+    // A value of 0 removes the given of the square
+    void set_given(Position row, Position column, Value value);
+    void clear_given(Position row, Position column);
+    // Replaces the givens by the non-empty squares of the board
+    void set_givens(SudokuBoardView board);
+    const SudokuBoard& get_givens() const;
+
+    // Returns false if the current givens are found to contradict each other
+    bool is_consistent();
+    // Returns true if the puzzle has a solution with the current givens
+    bool solve();
+    // Like solve, but gives up with UNKNOWN once one of the limits is reached
+    SolveResult solve_limited(const Settings::SolveLimits& limits);
+    // Returns the number of solutions with the current givens, up to limit
+    int count_solutions(int limit);
+    // Returns true if the current givens have exactly one solution
+    bool is_unique();
+    SudokuBoard get_solution() const;
+    // Returns the statistics of the last solve, count_solutions or is_unique
+    SolverStats get_stats() const;
+    // The callback is called now and then during solve and count_solutions
+    void set_progress_callback(ProgressCallback callback);
+    // Stops a running solve or count_solutions from another thread. An
+    // interrupt between solves stops the next one.
+    void interrupt();
+    // Drops an interrupt that arrived between solves
+    void clear_interrupt();
+
+private:
+    void update_assumptions();
+
+    std::unique_ptr<SudokuEngine> m_engine;
+    SudokuBoard m_givens;
+    bool m_givens_changed = true;
+    bool m_consistent = true;
+};
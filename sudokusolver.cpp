@@ -1,6 +1,10 @@
 #include "sudokusolver.hpp"
+#include "cardinality.hpp"
+#include "compiledlayout.hpp"
 
+#include <algorithm>
 #include <iostream>
+#include <map>
 
 namespace Settings {
 namespace Sudoku {
@@ -347,83 +351,182 @@ BoardSettings get_board_settings(Type type)
                                   {{14,8}, 9}, {{14,12}, 6},
                                  };
     }
+    else if (type == Type::S25X25)
+    {
+        board_settings.rows = 25;
+        board_settings.columns = 25;
+        board_settings.values = 25;
+        board_settings.min_value = 0;
+        board_settings.max_value = 25;
+        for (int i = 0; i < 25; ++i)
+        {
+            board_settings.regions.push_back({getHorizontalRegion(i,0,25), PuzzleColor::NONE});
+        }
+        for (int i = 0; i < 25; ++i)
+        {
+            board_settings.regions.push_back({getVerticalRegion(0,i,25), PuzzleColor::NONE});
+        }
+        for (int i = 0; i < 25; ++i)
+        {
+            board_settings.regions.push_back({getMinibox(5 * (i / 5), 5 * (i % 5), 5), (i % 2 == 0) ? PuzzleColor::A : PuzzleColor::B});
+        }
+        board_settings.has_example = false;
+    }
     return board_settings;
 }
 
+bool get_standard_type(int values, Type& type)
+{
+    static const std::map<int, Type> types = { {9, Type::S9X9},
+                                               {16, Type::S16X16},
+                                               {25, Type::S25X25},
+                                             };
+    if (types.count(values) == 0)
+    {
+        return false;
+    }
+    type = types.at(values);
+    return true;
+}
+
 }
 }
 
 namespace {
-
-void log_var(Minisat::Lit lit) {
-    if (sign(lit)) {
-        std::clog << '-';
+    // MiniSat never releases a variable, so every count_solutions retires
+    // one activation variable for good. After this many the next
+    // assume_board rebuilds the encoding, so long lived solvers do not grow.
+    const int MAX_RETIRED_ACTIVATIONS = 1000;
+
+    // Single propagation cannot hold the candidates of larger layouts, their
+    // encoding is always built in full
+    Settings::SolverOptions supported_options(Settings::SolverOptions solver_options, const CompiledLayout& layout) {
+        solver_options.presolve = solver_options.presolve && SinglePropagation::supports(layout);
+        return solver_options;
     }
-    std::clog << var(lit) + 1 << ' ';
 }
 
-void log_clause(Minisat::vec<Minisat::Lit> const& clause) {
-    for (int i = 0; i < clause.size(); ++i) {
-        log_var(clause[i]);
+SudokuSolver::SudokuSolver(std::shared_ptr<const CompiledLayout> layout, Settings::SolverOptions solver_options, bool write_dimacs)
+    : m_write_dimacs(write_dimacs)
+    , m_solver_options(supported_options(solver_options, *layout))
+    , solver(create_sat_backend(m_solver_options))
+    , m_layout(std::move(layout))
+    , m_board_settings(m_layout->get_board_settings())
+    , m_propagation(*m_layout)
+    , m_variables(m_layout->get_cells() * m_board_settings.values, var_Undef)
+    , m_decided(m_board_settings.rows, m_board_settings.columns)
+{
+    // With presolve the encoding waits for the first board, which decides
+    // whether it can be reduced
+    if (!m_solver_options.presolve) {
+        encode();
     }
-    std::clog << "0\n";
 }
 
-void log_clause(Minisat::Lit lhs, Minisat::Lit rhs) {
-    log_var(lhs); log_var(rhs);
-    std::clog << "0\n";
+Minisat::Var SudokuSolver::toVar(int cell, int value) const {
+    assert(cell >= 0 && cell < m_layout->get_cells() && "Attempt to get var for nonexistant cell");
+    assert(value >= 0 && value < m_board_settings.values && "Attempt to get var for nonexistant value");
+    return m_variables[cell * m_board_settings.values + value];
 }
 
+bool SudokuSolver::is_valid(SudokuBoardView b) const {
+    if ((b.get_rows() != m_board_settings.rows) || (b.get_columns() != m_board_settings.columns)) {
+        return false;
+    }
+    for (Value value : b) {
+        if (value < m_board_settings.min_value || value > m_board_settings.max_value) {
+            return false;
+        }
+    }
+    return true;
+}
 
-} //end anonymous namespace
-
-SudokuSolver::SudokuSolver(Settings::Sudoku::BoardSettings board_settings, bool write_dimacs)
-    : m_write_dimacs(write_dimacs)
-    , m_board_settings(board_settings)
-{
-    // Initialize the board
+void SudokuSolver::encode() {
+    ScopedTimer timer(m_stats.encode_ms);
     init_variables();
     one_square_one_value();
     non_duplicated_values();
+    m_encoded = true;
 }
 
-Minisat::Var SudokuSolver::toVar(int row, int column, int value)  const{
-    assert(row >= 0 && row < m_board_settings.rows && "Attempt to get var for nonexistant row");
-    assert(column >= 0 && column < m_board_settings.columns && "Attempt to get var for nonexistant column");
-    assert(value >= 0 && value < m_board_settings.values && "Attempt to get var for nonexistant value");
-    return row * m_board_settings.columns * m_board_settings.values + column * m_board_settings.values + value;
+void SudokuSolver::rebuild() {
+    std::unique_ptr<SatBackend> fresh = create_sat_backend(m_solver_options);
+    m_interrupter.set_solver(fresh.get());
+    solver = std::move(fresh);
+    std::fill(m_variables.begin(), m_variables.end(), var_Undef);
+    m_retired_activations = 0;
+    m_encoded = false;
 }
 
-bool SudokuSolver::is_valid(SudokuBoard const& b) const {
-    if (b.size() != m_board_settings.rows) {
-        return false;
+void SudokuSolver::encode_reduced(SinglePropagation::State const& state) {
+    ScopedTimer timer(m_stats.encode_ms);
+    if (m_write_dimacs) {
+        std::clog << "c (row, column, value) = variable\n";
     }
-    for (int row = 0; row < m_board_settings.rows; ++row) {
-        if (b[row].size() != m_board_settings.columns) {
-            return false;
+    for (int cell : m_layout->get_active_cells()) {
+        if (state.values[cell] != 0) {
+            m_decided.data()[cell] = state.values[cell];
+            continue;
         }
-        for (int col = 0; col < m_board_settings.columns; ++col) {
-            auto value = b[row][col];
-            if (value < m_board_settings.min_value || value > m_board_settings.max_value) {
-                return false;
+        Minisat::vec<Minisat::Lit> literals;
+        for (int value = 0; value < m_board_settings.values; ++value) {
+            if ((state.candidates[cell] >> value) & 1) {
+                literals.push(Minisat::mkLit(new_variable(cell, value)));
             }
         }
+        exactly_one_true(literals);
     }
-    return true;
+    // A value that is placed in a region was removed from the candidates of
+    // the other cells of the region, so only the open values need a clause
+    for (int region = 0; region < m_layout->get_region_count(); ++region) {
+        SinglePropagation::Candidates placed = 0;
+        for (int cell : m_layout->get_region(region)) {
+            if (state.values[cell] != 0) {
+                placed |= state.candidates[cell];
+            }
+        }
+        for (int value = 0; value < m_board_settings.values; ++value) {
+            if ((placed >> value) & 1) {
+                continue;
+            }
+            Minisat::vec<Minisat::Lit> literals;
+            for (int cell : m_layout->get_region(region)) {
+                if (toVar(cell, value) != var_Undef) {
+                    literals.push(Minisat::mkLit(toVar(cell, value)));
+                }
+            }
+            exactly_one_true(literals);
+        }
+    }
+    std::clog << std::flush;
+    m_encoded = true;
+    m_reduced = true;
+}
+
+Minisat::Var SudokuSolver::new_variable(int cell, int value) {
+    const Minisat::Var var = solver->new_var();
+    // Cells are decoded from the model, assumed by assume_board and blocked
+    // by count_solutions, so preprocessing may only eliminate the auxiliary
+    // variables of the encoding
+    solver->freeze(var);
+    m_variables[cell * m_board_settings.values + value] = var;
+    if (m_write_dimacs) {
+        std::clog << "c (" << cell / m_board_settings.columns << ", " << cell % m_board_settings.columns << ", " << value + 1 << ") = " << var + 1 << '\n';
+    }
+    return var;
 }
 
 void SudokuSolver::init_variables() {
     if (m_write_dimacs) {
         std::clog << "c (row, column, value) = variable\n";
     }
-    for (int r = 0; r < m_board_settings.rows; ++r) {
-        for (int c = 0; c < m_board_settings.columns; ++c) {
-            for (int v = 0; v < m_board_settings.values; ++v) {
-                auto var = solver.newVar();
-                if (m_write_dimacs) {
-                    std::clog << "c (" << r << ", " << c << ", " << v + 1 << ") = " << var + 1 << '\n';
-                }
-            }
+    // Only the cells of the regions get variables, the empty points and the
+    // other cells outside every region are left out of the encoding
+    for (int cell : m_layout->get_active_cells()) {
+        for (int v = 0; v < m_board_settings.values; ++v) {
+            const Minisat::Var var = new_variable(cell, v);
+            assert(var == m_layout->first_variable(cell) + v);
+            (void)var;
         }
     }
     std::clog << std::flush;
@@ -431,81 +534,274 @@ void SudokuSolver::init_variables() {
 
 
 void SudokuSolver::exactly_one_true(Minisat::vec<Minisat::Lit> const& literals) {
-    if (m_write_dimacs) {
-        log_clause(literals);
-    }
-    solver.addClause(literals);
-    for (size_t i = 0; i < literals.size(); ++i) {
-        for (size_t j = i + 1; j < literals.size(); ++j) {
-            if (m_write_dimacs) {
-                log_clause(~literals[i], ~literals[j]);
-            }
-            solver.addClause(~literals[i], ~literals[j]);
-        }
-    }
+    Cardinality::exactly_one(*solver, literals, m_solver_options.amo_encoding, m_write_dimacs);
 }
 
 void SudokuSolver::one_square_one_value() {
-    for (int row = 0; row < m_board_settings.rows; ++row) {
-        for (int column = 0; column < m_board_settings.columns; ++column) {
-            Minisat::vec<Minisat::Lit> literals;
-            for (int value = 0; value < m_board_settings.values; ++value) {
-                literals.push(Minisat::mkLit(toVar(row, column, value)));
-            }
-            exactly_one_true(literals);
+    for (int cell : m_layout->get_active_cells()) {
+        Minisat::vec<Minisat::Lit> literals;
+        for (int value = 0; value < m_board_settings.values; ++value) {
+            literals.push(Minisat::mkLit(toVar(cell, value)));
         }
+        exactly_one_true(literals);
     }
 }
 
 void SudokuSolver::non_duplicated_values() {
     // Allow every value only once in an adjacent region
-    for (auto region : m_board_settings.regions)
+    for (int region = 0; region < m_layout->get_region_count(); ++region)
     {
         for (int value = 0; value < m_board_settings.values; ++value) {
             Minisat::vec<Minisat::Lit> literals;
-            for (auto point : region.first) {
-                literals.push(Minisat::mkLit(toVar(point.first, point.second, value)));
+            for (int cell : m_layout->get_region(region)) {
+                literals.push(Minisat::mkLit(toVar(cell, value)));
             }
             exactly_one_true(literals);
         }
     }
 }
 
-bool SudokuSolver::apply_board(const SudokuBoard& b) {
+bool SudokuSolver::apply_board(SudokuBoardView b) {
     assert(is_valid(b) && "Provided board is not valid!");
+    if (!m_encoded && m_solver_options.presolve) {
+        SinglePropagation::State state;
+        bool consistent;
+        {
+            ScopedTimer timer(m_stats.apply_ms);
+            state = m_propagation.initial_state();
+            consistent = m_propagation.apply_givens(state, b);
+        }
+        if (!consistent) {
+            // Nothing to encode, the empty clause makes every solve fail
+            m_encoded = true;
+            m_reduced = true;
+            return solver->add_clause(Minisat::vec<Minisat::Lit>());
+        }
+        encode_reduced(state);
+        // Propagation decided the givens of the regions, this keeps the others
+        bool ret = true;
+        for (int cell = 0; cell < b.size(); ++cell) {
+            if (b.data()[cell] != 0) {
+                ret &= add_given(cell, b.data()[cell]);
+            }
+        }
+        m_propagated = ret && is_decided();
+        return ret;
+    }
+    if (!m_encoded) {
+        encode();
+    }
+    ScopedTimer timer(m_stats.apply_ms);
+    m_applied = true;
+    if (!m_reduced) {
+        // Nothing of a previous assume_board holds for the new givens, only
+        // the cells outside every region keep the values of earlier boards
+        m_assumptions.clear();
+        m_propagated = false;
+        for (int cell : m_layout->get_active_cells()) {
+            m_decided.data()[cell] = 0;
+        }
+    }
     bool ret = true;
-    for (int row = 0; row < m_board_settings.rows; ++row) {
-        for (int col = 0; col < m_board_settings.columns; ++col) {
-            auto value = b[row][col];
+    for (int cell = 0; cell < b.size(); ++cell) {
+        auto value = b.data()[cell];
+        if (value != 0) {
+            ret &= add_given(cell, value);
+        }
+    }
+    return ret;
+}
+
+bool SudokuSolver::add_given(int cell, Value value) {
+    const Minisat::Var var = toVar(cell, value - 1);
+    if (var != var_Undef) {
+        return solver->add_clause(Minisat::mkLit(var));
+    }
+    if (!m_layout->is_active(cell)) {
+        // Any value fits a cell outside every region
+        m_decided.data()[cell] = value;
+        return true;
+    }
+    if (m_decided.data()[cell] == value) {
+        return true;
+    }
+    // The value was eliminated by the reduction
+    m_propagated = false;
+    return solver->add_clause(Minisat::vec<Minisat::Lit>());
+}
+
+bool SudokuSolver::assume_board(SudokuBoardView b) {
+    assert(is_valid(b) && "Provided board is not valid!");
+    assert(!m_reduced && "The reduced encoding only holds the board of apply_board");
+    if ((m_retired_activations >= MAX_RETIRED_ACTIVATIONS) && !m_applied) {
+        rebuild();
+    }
+    if (!m_encoded) {
+        encode();
+    }
+    ScopedTimer timer(m_stats.apply_ms);
+    std::copy(b.begin(), b.end(), m_decided.data());
+    bool consistent;
+    if (m_solver_options.presolve) {
+        SinglePropagation::State state = m_propagation.initial_state();
+        consistent = m_propagation.apply_givens(state, b);
+        if (consistent) {
+            for (int cell : m_layout->get_active_cells()) {
+                m_decided.data()[cell] = state.values[cell];
+            }
+        }
+    } else {
+        consistent = !has_duplicated_givens(b);
+    }
+    m_propagated = m_solver_options.presolve && consistent && is_decided();
+    m_assumptions.clear();
+    for (int cell : m_layout->get_active_cells()) {
+        auto value = m_decided.data()[cell];
+        if (value != 0) {
+            m_assumptions.push(Minisat::mkLit(toVar(cell, value - 1)));
+        }
+    }
+    return consistent;
+}
+
+bool SudokuSolver::is_decided() const {
+    for (int cell : m_layout->get_active_cells()) {
+        if (m_decided.data()[cell] == 0) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SudokuSolver::has_duplicated_givens(SudokuBoardView b) const {
+    std::vector<bool> seen(m_board_settings.values + 1);
+    for (int region = 0; region < m_layout->get_region_count(); ++region) {
+        std::fill(seen.begin(), seen.end(), false);
+        for (int cell : m_layout->get_region(region)) {
+            auto value = b.data()[cell];
             if (value != 0) {
-                ret &= solver.addClause(Minisat::mkLit(toVar(row, col, value - 1)));
+                if (seen[value]) {
+                    return true;
+                }
+                seen[value] = true;
             }
         }
     }
-    return ret;
+    return false;
 }
 
 bool SudokuSolver::solve() {
-    return solver.solve();
+    return solve_limited(Settings::SolveLimits()) == SolveResult::SAT;
 }
 
-SudokuBoard SudokuSolver::get_solution() const {
-    SudokuBoard b(m_board_settings.rows, std::vector<int>(m_board_settings.columns));
-    for (int row = 0; row < m_board_settings.rows; ++row) {
-        for (int col = 0; col < m_board_settings.columns; ++col) {
-            if (m_board_settings.empty_points.count(Point(row,col)) == 0)
-            {
-                int found = 0;
-                for (int val = 0; val < m_board_settings.values; ++val) {
-                    if (solver.modelValue(toVar(row, col, val)).isTrue()) {
-                        ++found;
-                        b[row][col] = val + 1;
-                    }
+SolveResult SudokuSolver::solve_limited(Settings::SolveLimits const& limits) {
+    SolveControl::Interrupter::Scope interrupt_scope(m_interrupter);
+    SolveStatsRecorder<SatBackend> recorder(*solver, m_stats);
+    if (m_propagated) {
+        return SolveResult::SAT;
+    }
+    const SolveControl::Budget budget(*solver, limits);
+    const Minisat::lbool result = SolveControl::solve(*solver, m_assumptions, m_interrupter.interrupted(), recorder.report_to(m_progress_callback), budget);
+    return SolveControl::to_solve_result(result);
+}
+
+int SudokuSolver::count_solutions(int limit) {
+    SolveControl::Interrupter::Scope interrupt_scope(m_interrupter);
+    SolveStatsRecorder<SatBackend> recorder(*solver, m_stats);
+    if (m_propagated) {
+        // Propagation alone decided every cell, so there is no other solution
+        return std::min(limit, 1);
+    }
+    // The blocking clauses only hold while the activation literal is assumed,
+    // so they can be retired afterwards and leave the encoding reusable.
+    const Minisat::Lit activation = Minisat::mkLit(solver->new_var());
+    Minisat::vec<Minisat::Lit> assumptions;
+    m_assumptions.copyTo(assumptions);
+    assumptions.push(activation);
+    std::vector<bool> assumed(solver->get_stats().variables, false);
+    for (auto const& assumption : m_assumptions) {
+        assumed[var(assumption)] = true;
+    }
+
+    int count = 0;
+    Minisat::vec<Minisat::lbool> first_model;
+    const auto on_progress = recorder.report_to(m_progress_callback);
+    while ((count < limit) && SolveControl::solve(*solver, assumptions, m_interrupter.interrupted(), on_progress).isTrue()) {
+        if (count == 0) {
+            solver->model.copyTo(first_model);
+        }
+        ++count;
+        // Block the values of the open squares in this solution
+        Minisat::vec<Minisat::Lit> blocking;
+        blocking.push(~activation);
+        for (int cell : m_layout->get_active_cells()) {
+            for (int val = 0; val < m_board_settings.values; ++val) {
+                const Minisat::Var var = toVar(cell, val);
+                if ((var != var_Undef) && !assumed[var] && solver->model_value(var).isTrue()) {
+                    blocking.push(~Minisat::mkLit(var));
                 }
-                assert(found == 1 && "The SAT solver assigned one position more than one value");
-                (void)found;
             }
         }
+        solver->add_clause(blocking);
+    }
+    solver->add_clause(~activation);
+    ++m_retired_activations;
+    // Later solves overwrote the model, get_solution should return the first
+    if (count > 0) {
+        first_model.moveTo(solver->model);
+    }
+    return count;
+}
+
+SudokuBoard SudokuSolver::get_solution() const {
+    SudokuBoard b(m_board_settings.rows, m_board_settings.columns);
+    Square* square = b.data();
+    for (int cell = 0; cell < b.size(); ++cell) {
+        if (!m_layout->is_used(cell)) {
+            continue;
+        }
+        if (m_decided.data()[cell] != 0) {
+            square[cell] = m_decided.data()[cell];
+            continue;
+        }
+        if (!m_layout->is_active(cell)) {
+            // A cell outside every region can take any value
+            square[cell] = 1;
+            continue;
+        }
+        int found = 0;
+        for (int value = 0; value < m_board_settings.values; ++value) {
+            const Minisat::Var var = toVar(cell, value);
+            if ((var != var_Undef) && solver->model_value(var).isTrue()) {
+                ++found;
+                square[cell] = value + 1;
+            }
+        }
+        assert(found == 1 && "The SAT solver assigned one position more than one value");
+        (void)found;
     }
     return b;
 }
+
+SolverStats SudokuSolver::get_stats() const {
+    SolverStats stats = m_stats;
+    const SolverStats backend_stats = solver->get_stats();
+    stats.variables = backend_stats.variables;
+    stats.clauses = backend_stats.clauses;
+    stats.eliminated_variables = backend_stats.eliminated_variables;
+    stats.removed_clauses = backend_stats.removed_clauses;
+    stats.preprocess_ms = backend_stats.preprocess_ms;
+    return stats;
+}
+
+void SudokuSolver::set_progress_callback(ProgressCallback callback) {
+    m_progress_callback = callback;
+}
+
+void SudokuSolver::interrupt() {
+    m_interrupter.interrupt();
+}
+
+void SudokuSolver::clear_interrupt() {
+    m_interrupter.clear_interrupt();
+}
@@ -1,7 +1,12 @@
 #pragma once
 
 #include "puzzle_types.hpp"
-#include <minisat/core/Solver.h>
+#include "sat_backend.hpp"
+#include "single_propagation.hpp"
+#include "solve_control.hpp"
+#include "solver_options.hpp"
+#include "sudokuengine.hpp"
+#include <memory>
 #include <utility>
 #include <vector>
 
@@ -14,6 +19,7 @@ enum class Type
     S16X16,
     T9X15,
     M9X9_TWICE_COUPLED,
+    S25X25,
 };
 
 struct BoardSettings
@@ -32,29 +38,88 @@ struct BoardSettings
 };
 
 BoardSettings get_board_settings(Type type);
+// Finds the type of the standard sudoku with the given number of values,
+// which has that many rows and columns. Returns false if there is none.
+bool get_standard_type(int values, Type& type);
 
 }
 }
 
-class SudokuSolver {
+class CompiledLayout;
+
+class SudokuSolver : public SudokuEngine {
 public:
-    SudokuSolver(Settings::Sudoku::BoardSettings board_settings, bool write_dimacs = false);
-    // Returns true if the provided board satisfies the constraints
-    bool apply_board(SudokuBoard const&);
+    SudokuSolver(std::shared_ptr<const CompiledLayout> layout, Settings::SolverOptions solver_options = Settings::SolverOptions(), bool write_dimacs = false);
+    // Returns true if the provided board satisfies the constraints. With
+    // presolve, the first board of a new solver is propagated before the
+    // encoding is built, which then leaves out the decided cells and the
+    // eliminated values. Later boards are added on top of that encoding.
+    // Layouts with more values than SinglePropagation holds are never
+    // presolved. The assumptions of an earlier assume_board are dropped.
+    bool apply_board(SudokuBoardView) override;
+    // Replaces the givens of the previous board by the givens of the provided
+    // board. They are passed as assumptions to the next solve, so the clauses
+    // of the base encoding are reused. With presolve, the cells decided by
+    // propagation are assumed as well. Returns false if givens share a region
+    // and a value, or propagation runs into a contradiction. Cannot follow
+    // apply_board with presolve, whose encoding is reduced to its board.
+    bool assume_board(SudokuBoardView) override;
     // Returns true if the sudoku has a solution
-    bool solve();
-    SudokuBoard get_solution() const;
+    bool solve() override;
+    SolveResult solve_limited(Settings::SolveLimits const& limits) override;
+    int count_solutions(int limit) override;
+    SudokuBoard get_solution() const override;
+    SolverStats get_stats() const override;
+    void set_progress_callback(ProgressCallback callback) override;
+    void interrupt() override;
+    void clear_interrupt() override;
 
 private:
-    Minisat::Var toVar(int row, int column, int value) const;
-    bool is_valid(SudokuBoard const& b) const;
+    // The variable of a value (0 based) of a cell, var_Undef if the encoding
+    // does not contain it
+    Minisat::Var toVar(int cell, int value) const;
+    bool is_valid(SudokuBoardView b) const;
+    bool has_duplicated_givens(SudokuBoardView b) const;
+
+    // Builds the encoding of the layout for any board
+    void encode();
+    // Replaces the SAT solver by a new one without encoding
+    void rebuild();
+    // Builds the encoding of the open cells and candidates of a propagated board
+    void encode_reduced(SinglePropagation::State const& state);
+    bool add_given(int cell, Value value);
+    // Returns true if every active cell has a value in m_decided
+    bool is_decided() const;
 
+    Minisat::Var new_variable(int cell, int value);
     void one_square_one_value();
     void non_duplicated_values();
     void exactly_one_true(Minisat::vec<Minisat::Lit> const& literals);
     void init_variables();
 
     const bool m_write_dimacs = false;
-    Minisat::Solver solver;
-    Settings::Sudoku::BoardSettings m_board_settings;
+    const Settings::SolverOptions m_solver_options;
+    // Replaced by rebuild, m_interrupter follows it
+    std::unique_ptr<SatBackend> solver;
+    Minisat::vec<Minisat::Lit> m_assumptions;
+    const std::shared_ptr<const CompiledLayout> m_layout;
+    const Settings::Sudoku::BoardSettings& m_board_settings;
+    const SinglePropagation m_propagation;
+    // Variable of every value of every cell, values per cell
+    std::vector<Minisat::Var> m_variables;
+    bool m_encoded = false;
+    bool m_reduced = false;
+    // Set once apply_board added givens as clauses, which a rebuild would lose
+    bool m_applied = false;
+    // Activation variables of count_solutions since the last rebuild
+    int m_retired_activations = 0;
+    // The givens and the values propagation decided for the board, which is
+    // the solution when m_propagated is set
+    SudokuBoard m_decided;
+    // Set when propagation decided every cell, so that solving does not need
+    // MiniSat
+    bool m_propagated = false;
+    SolverStats m_stats;
+    ProgressCallback m_progress_callback;
+    SolveControl::Interrupter m_interrupter{solver.get()};
 };